@@ -8,22 +8,32 @@
 //               Developed as part of the CS499 Capstone project.
 //============================================================================
 
+#include <cctype>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <string>
 #include <vector>
 #include "ABCUApp.hpp"
+#include "BackgroundLoader.hpp"
+#include "BlockCatalog.hpp"
 #include "BST.hpp"
+#include "CourseLoader.hpp"
+#include "EmbeddedCatalog.hpp"
+#include "Snapshot.hpp"
+#include "Latency.hpp"
 #include <iomanip>
 #include <limits>
 #include <algorithm>
 #include <filesystem>
 
 
-// Using BST namespace for BinarySearchTree and Course classes.
+// Using BST namespace for CourseTree and Course classes.
 using namespace BST;
 
+// Courses per page of the ordered course list (Case 13).
+const int COURSE_PAGE_SIZE = 20;
+
 // Main entry point of the ABCU Course App.
 // Parameters:
 //   argc - Number of command-line arguments.
@@ -32,15 +42,160 @@ using namespace BST;
 int main(int argc, char *argv[])
 {
     std::string filepath = "";
+    std::string snapshotPath = "";
+    int loadThreads = -1;       // Serial loading of the next 100 courses by default.
+    bool statsOnExit = false;   // Print the tree's operation counters when exiting.
+    bool latencyOnExit = false; // Print the latency percentiles when exiting.
+    std::vector<std::string> searches; // Name searches to run instead of the menu.
+    std::vector<std::string> deltas;   // Delta files to apply after loading.
+    bool sharded = false;              // Load into the department-sharded catalog.
+    std::string blocksPath = "";       // Block file to serve out of core, if any.
+    size_t cacheBlocks = DEFAULT_CACHE_BLOCKS; // Blocks the out-of-core cache holds.
+
+    // Optional flags:
+    //   --threads N       - Load the whole file at once with N worker threads (0 for all cores).
+    //   --snapshot FILE   - Start from a saved binary snapshot instead of a text file.
+    //   --stats           - Print the tree's operation counters on exit.
+    //   --latency         - Print latency percentiles of the tree operations on exit.
+    //   --file FILE       - Load the whole text catalog at startup.
+    //   --search QUERY    - Print the courses whose names match, then exit (repeatable).
+    //   --delta FILE      - Apply a delta file to the loaded catalog (repeatable).
+    //   --sharded         - Load the whole text catalog into one tree per department.
+    //   --blocks FILE     - Serve the catalog out of core from a block file, building
+    //                       it from the text catalog first if it does not exist.
+    //   --cache-blocks N  - Blocks of the block file kept in memory (default 64).
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+        {
+            try
+            {
+                loadThreads = std::max(0, std::stoi(argv[++i]));
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Invalid thread count, loading serially." << std::endl;
+            }
+        }
+        else if (arg == "--snapshot" && i + 1 < argc)
+        {
+            snapshotPath = argv[++i];
+        }
+        else if (arg == "--stats")
+        {
+            statsOnExit = true;
+        }
+        else if (arg == "--latency")
+        {
+            latencyOnExit = true;
+        }
+        else if (arg == "--file" && i + 1 < argc)
+        {
+            filepath = argv[++i];
+        }
+        else if (arg == "--search" && i + 1 < argc)
+        {
+            searches.push_back(argv[++i]);
+        }
+        else if (arg == "--delta" && i + 1 < argc)
+        {
+            deltas.push_back(argv[++i]);
+        }
+        else if (arg == "--sharded")
+        {
+            sharded = true;
+        }
+        else if (arg == "--blocks" && i + 1 < argc)
+        {
+            blocksPath = argv[++i];
+        }
+        else if (arg == "--cache-blocks" && i + 1 < argc)
+        {
+            try
+            {
+                cacheBlocks = std::max(1, std::stoi(argv[++i]));
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "Invalid cache size, keeping " << cacheBlocks << " blocks." << std::endl;
+            }
+        }
+    }
+
     // Display welcome message to the user.
     std::cout << "         Welcome to ABCU Course App         " << std::endl;
 
-    BinarySearchTree tree;
+    CourseTree tree;
+    MappedCatalog snapshot;
+    EmbeddedCatalog embedded; // Compiled-in catalog, served when nothing else is loaded at startup.
+    BlockCatalog blocks;      // Out-of-core catalog, served instead of the tree with --blocks.
+    ShardedCatalog shards;   // Serves the menu instead of the tree when loaded with --sharded.
+    BackgroundLoader loader; // Whole-file load running behind the menu, if any.
     int input;
 
+    // Serve lookups straight from the snapshot when it is intact, otherwise fall
+    // back to loading the whole text catalog.
+    if (!snapshotPath.empty())
+    {
+        if (snapshot.Open(snapshotPath))
+        {
+            std::cout << "Catalog mapped from snapshot: " << snapshot.GetSize() << " courses." << std::endl;
+        }
+        else
+        {
+            std::cout << "Snapshot missing or corrupt, loading the text catalog instead." << std::endl;
+            BuildStructureFromFile(filepath, tree, std::max(0, loadThreads));
+        }
+    }
+    else if (!blocksPath.empty())
+    {
+        OpenBlockFile(blocksPath, filepath, blocks, cacheBlocks);
+    }
+    else if (sharded)
+    {
+        BuildShardsFromFile(filepath, shards, std::max(0, loadThreads));
+    }
+    else if (!filepath.empty() || !searches.empty() || !deltas.empty())
+    {
+        BuildStructureFromFile(filepath, tree, std::max(0, loadThreads));
+    }
+    else if (embedded.Open())
+    {
+        std::cout << "Catalog compiled in: " << embedded.GetSize() << " courses." << std::endl;
+    }
+
+    // Apply the delta files in order, each one all or nothing.
+    for (const std::string &delta : deltas)
+    {
+        if (snapshot.IsOpen() || blocks.IsOpen() || shards.GetSize() > 0)
+        {
+            std::cout << "Delta files need the text catalog, not a snapshot, block file or sharded catalog." << std::endl;
+            break;
+        }
+        ReportDelta(delta, ApplyDeltaFile(delta, &tree));
+    }
+
+    // Batch mode: answer the name searches and exit without showing the menu.
+    for (const std::string &query : searches)
+    {
+        std::cout << "Search: " << query << std::endl;
+        if (snapshot.IsOpen() || blocks.IsOpen() || shards.GetSize() > 0)
+        {
+            std::cout << "Name search needs the text catalog, not a snapshot, block file or sharded catalog." << std::endl;
+            break;
+        }
+        tree.PrintNameSearch(query);
+    }
+
     // Main program loop, runs until the user chooses to exit.
-    while (true)
+    while (searches.empty())
     {
+        // A background load that has stopped replaces the catalog before the menu shows.
+        if (loader.IsOver())
+        {
+            FinishBackgroundLoad(loader, tree, snapshot, shards, embedded, blocks);
+        }
 
         // Display menu options and get user input.
         OutputMenuItems();
@@ -50,15 +205,152 @@ int main(int argc, char *argv[])
         switch (input)
         {
         case 1:
-            BuildStructureFromFile(filepath, tree); // Load course data into the BST from file.
+            if (loader.IsActive())
+            {
+                std::cout << "A background load is running, wait for it or cancel it (option 11)." << std::endl;
+                break;
+            }
+            snapshot.Close();                                    // The tree takes over from any snapshot.
+            shards.Clear();                                      // And from any sharded catalog.
+            embedded.Close();                                    // And from the compiled-in catalog.
+            blocks.Close();                                      // And from any block file.
+            BuildStructureFromFile(filepath, tree, loadThreads); // Load course data into the BST from file.
             break;
         case 2:
-            PrintCoursesInOrder(tree); // Print all courses in order.
+            if (snapshot.IsOpen())
+            {
+                PrintCoursesInOrder(snapshot);
+            }
+            else if (embedded.IsOpen())
+            {
+                PrintCoursesInOrder(embedded);
+            }
+            else if (blocks.IsOpen())
+            {
+                PrintCoursesInOrder(blocks);
+            }
+            else if (shards.GetSize() > 0)
+            {
+                PrintCoursesInOrder(shards);
+            }
+            else
+            {
+                PrintCoursesInOrder(tree); // Print all courses in order.
+            }
             break;
         case 3:
-            PrintOneCourse(tree); // Print details of a specific course.
+            if (snapshot.IsOpen())
+            {
+                PrintOneCourse(snapshot);
+            }
+            else if (embedded.IsOpen())
+            {
+                PrintOneCourse(embedded);
+            }
+            else if (blocks.IsOpen())
+            {
+                PrintOneCourse(blocks);
+            }
+            else if (shards.GetSize() > 0)
+            {
+                PrintOneCourse(shards);
+            }
+            else
+            {
+                PrintOneCourse(tree); // Print details of a specific course.
+            }
             break;
         case 4:
+            if (snapshot.IsOpen() || embedded.IsOpen() || blocks.IsOpen() || shards.GetSize() > 0)
+            {
+                std::cout << "Snapshots are saved from the text catalog, load it with option 1." << std::endl;
+            }
+            else
+            {
+                SaveCatalogSnapshot(tree); // Save the loaded catalog for fast startup.
+            }
+            break;
+        case 5:
+            if (blocks.IsOpen())
+            {
+                blocks.PrintCacheStats(); // Print the block cache's hit rate and bytes read.
+            }
+            else if (snapshot.IsOpen() || embedded.IsOpen() || shards.GetSize() > 0)
+            {
+                std::cout << "Tree counters need the text catalog, load it with option 1." << std::endl;
+            }
+            else
+            {
+                tree.PrintStats(); // Print the tree's operation counters.
+            }
+            break;
+        case 6:
+            PrintLatencyReport(std::cout); // Print latency percentiles per operation.
+            break;
+        case 7:
+            if (snapshot.IsOpen() || embedded.IsOpen() || blocks.IsOpen() || shards.GetSize() > 0)
+            {
+                std::cout << "Name search needs the text catalog, load it with option 1." << std::endl;
+            }
+            else
+            {
+                SearchCourseNames(tree); // Find courses by words in their names.
+            }
+            break;
+        case 8:
+            if (snapshot.IsOpen() || embedded.IsOpen() || blocks.IsOpen() || shards.GetSize() > 0)
+            {
+                std::cout << "Delta files need the text catalog, load it with option 1." << std::endl;
+            }
+            else if (loader.IsActive())
+            {
+                std::cout << "A background load is running, wait for it or cancel it (option 11)." << std::endl;
+            }
+            else
+            {
+                ApplyCatalogDelta(tree); // Add, remove and modify courses from a delta file.
+            }
+            break;
+        case 9:
+            StartBackgroundLoad(filepath, loader); // Load the whole file while the menu stays usable.
+            break;
+        case 10:
+            PrintLoadStatus(loader); // Print progress of the background load.
+            break;
+        case 11:
+            if (loader.IsActive())
+            {
+                if (loader.GetProgress().stage == LoadStage::Validating)
+                {
+                    // Validation cannot be interrupted, so say why the menu waits.
+                    std::cout << "The catalog is being validated, which cannot be cancelled, waiting for it to finish." << std::endl;
+                }
+                loader.Cancel(); // Stop the background load, the catalog is unchanged.
+                std::cout << "Background load cancelled, the catalog is unchanged." << std::endl;
+            }
+            else
+            {
+                std::cout << "No background load is running." << std::endl;
+            }
+            break;
+        case 12:
+            PrintDepartment(shards); // Print the courses of one department from its shard.
+            break;
+        case 13:
+            if (snapshot.IsOpen() || shards.GetSize() > 0 || embedded.IsOpen())
+            {
+                std::cout << "Course pages need the text catalog, load it with option 1." << std::endl;
+            }
+            else if (blocks.IsOpen())
+            {
+                PrintCoursePage(blocks); // Read only the blocks the page covers.
+            }
+            else
+            {
+                PrintCoursePage(tree); // Print one page of the ordered course list.
+            }
+            break;
+        case 0:
             // Exit option: Display goodbye message and exit loop.
             std::cout << "            Good bye!" << std::endl;
             break;
@@ -67,20 +359,54 @@ int main(int argc, char *argv[])
             std::cout << "            This is not an appropriate entry. Please try again." << std::endl;
             break;
         }
-        if (input == 4)
+        if (input == 0)
         {
             break; // Terminate loop when user selects exit.
         }
     }
+    if (statsOnExit)
+    {
+        tree.PrintStats();
+    }
+    if (latencyOnExit)
+    {
+        PrintLatencyReport(std::cout);
+    }
     return 0; // Successful program termination.
 }
 
 // Loads course data from a file into the Binary Search Tree (Case 1).
 // Parameters:
-//   tree - Reference to the BinarySearchTree to populate with course data.
-void BuildStructureFromFile(std::string &filePath, BST::BinarySearchTree &tree)
+//   tree        - Reference to the CourseTree to populate with course data.
+//   loadThreads - Worker threads for loading the whole file, or -1 to load the next 100 courses.
+void BuildStructureFromFile(std::string &filePath, BST::CourseTree &tree, int loadThreads)
 {
+    if (!GetCourseFilePath(filePath))
+    {
+        return;
+    }
+
+    // Attempt to read course data from the default file "CourseList.txt".
+    bool isRead = loadThreads < 0 ? ReadCourseFile(filePath, &tree)
+                                  : ReadCourseFileParallel(filePath, &tree, loadThreads);
+
+    if (isRead)
+    {
+        std::cout << "Tree populated with courses." << std::endl;
+    }
+    else
+    {
+        std::cout << "Tree failed to populate with courses." << std::endl;
+        tree.Clear(); // Clear tree on failure to maintain consistency.
+    }
+}
 
+// Asks the user for the course file unless the current path names an existing file.
+// Parameters:
+//   filePath - The course file path, replaced by the user's choice if needed.
+// Returns: True if there is a path to load, false if the user entered none.
+bool GetCourseFilePath(std::string &filePath)
+{
     if (filePath.size() < 1 || !std::filesystem::exists(filePath))
     {
         std::string message = "            Enter the file name for the courses list (no extension).";
@@ -91,30 +417,99 @@ void BuildStructureFromFile(std::string &filePath, BST::BinarySearchTree &tree)
         if (userInput.size() < 1)
         {
             std::cout << "Improper filename. Please try again." << std::endl;
-            return;
+            return false;
         }
         userInput += ".txt";
         filePath = userInput;
     }
+    return true;
+}
 
-    // Attempt to read course data from the default file "CourseList.txt".
-    bool isRead = ReadCourseFile(filePath, &tree);
+// Starts loading the whole course file in the background (Case 9).
+// Parameters:
+//   filePath - The course file, asked for if it does not exist.
+//   loader   - The background loader to start.
+void StartBackgroundLoad(std::string &filePath, BST::BackgroundLoader &loader)
+{
+    if (loader.IsActive())
+    {
+        std::cout << "A background load is already running." << std::endl;
+        return;
+    }
+    if (!GetCourseFilePath(filePath))
+    {
+        return;
+    }
+    if (loader.Start(filePath))
+    {
+        std::cout << "Loading " << filePath << " in the background, option 10 shows progress." << std::endl;
+    }
+    else
+    {
+        std::cerr << "Error, File doesn't exist." << std::endl;
+    }
+}
 
-    if (isRead)
+// Prints the progress of the background load with its rate and time left (Case 10).
+// Parameters:
+//   loader - The background loader to report on.
+void PrintLoadStatus(BST::BackgroundLoader &loader)
+{
+    LoadProgress progress = loader.GetProgress();
+    if (progress.stage == LoadStage::Idle)
     {
-        std::cout << "Tree populated with courses." << std::endl;
+        std::cout << "No background load is running." << std::endl;
+        return;
+    }
+    double fraction = progress.totalBytes == 0 ? 1 : static_cast<double>(progress.bytesDone) / progress.totalBytes;
+    double rate = progress.seconds > 0 ? progress.records / progress.seconds : 0;
+
+    std::cout << "------------------------------------------" << std::endl;
+    std::cout << "Load stage:           " << LoadStageName(progress.stage) << std::endl;
+    std::cout << "Courses read:         " << progress.records << std::endl;
+    std::cout << "Complete:             " << std::fixed << std::setprecision(1) << fraction * 100 << "%" << std::endl;
+    std::cout << "Courses per second:   " << std::setprecision(0) << rate << std::endl;
+    if (progress.stage == LoadStage::Loading && fraction > 0)
+    {
+        std::cout << "Time left:            " << std::setprecision(1) << progress.seconds * (1 - fraction) / fraction << " s" << std::endl;
     }
     else
     {
-        std::cout << "Tree failed to populate with courses." << std::endl;
-        tree.Clear(); // Clear tree on failure to maintain consistency.
+        std::cout << "Elapsed:              " << std::setprecision(1) << progress.seconds << " s" << std::endl;
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << "------------------------------------------" << std::endl;
+}
+
+// Hands a stopped background load's catalog to the tree, replacing any snapshot.
+// Parameters:
+//   loader   - The background loader that has stopped.
+//   tree     - The catalog to replace.
+//   snapshot - The mapped snapshot, closed once the tree takes over.
+//   shards   - The sharded catalog, cleared once the tree takes over.
+//   embedded - The compiled-in catalog, closed once the tree takes over.
+//   blocks   - The block file, closed once the tree takes over.
+void FinishBackgroundLoad(BST::BackgroundLoader &loader, BST::CourseTree &tree, BST::MappedCatalog &snapshot,
+                          BST::ShardedCatalog &shards, BST::EmbeddedCatalog &embedded, BST::BlockCatalog &blocks)
+{
+    if (loader.Finish(tree))
+    {
+        snapshot.Close();
+        shards.Clear();
+        embedded.Close();
+        blocks.Close();
+        std::cout << "Background load finished, tree populated with " << tree.GetSize() << " courses." << std::endl;
+    }
+    else
+    {
+        std::cout << "Background load failed, the catalog is unchanged." << std::endl;
     }
 }
 
 // Prints all courses in the Binary Search Tree in order (Case 2).
 // Parameters:
-//   tree - Reference to the BinarySearchTree containing course data.
-void PrintCoursesInOrder(BST::BinarySearchTree &tree)
+//   tree - Reference to the CourseTree containing course data.
+void PrintCoursesInOrder(BST::CourseTree &tree)
 {
     if (tree.GetSize() == 0)
     {
@@ -129,10 +524,216 @@ void PrintCoursesInOrder(BST::BinarySearchTree &tree)
     }
 }
 
+// Loads the whole course file into the department-sharded catalog (--sharded).
+// Parameters:
+//   filePath    - The course file, asked for if it does not exist.
+//   shards      - The sharded catalog to replace.
+//   loadThreads - Worker threads, 0 to use every hardware thread.
+void BuildShardsFromFile(std::string &filePath, BST::ShardedCatalog &shards, int loadThreads)
+{
+    if (!GetCourseFilePath(filePath))
+    {
+        return;
+    }
+    if (ReadCourseFileSharded(filePath, &shards, loadThreads))
+    {
+        std::cout << "Catalog loaded into " << shards.GetShardCount() << " department shards." << std::endl;
+    }
+    else
+    {
+        std::cout << "Tree failed to populate with courses." << std::endl;
+        shards.Clear(); // Clear the catalog on failure to maintain consistency.
+    }
+}
+
+// Opens a block file to serve the catalog out of core (--blocks). A missing block
+// file is built from the text catalog first, without loading it into memory.
+// Parameters:
+//   blockPath   - The block file.
+//   filePath    - The course file to build it from, asked for if it does not exist.
+//   blocks      - The block catalog to open.
+//   cacheBlocks - Blocks the cache holds.
+void OpenBlockFile(const std::string &blockPath, std::string &filePath, BST::BlockCatalog &blocks, size_t cacheBlocks)
+{
+    if (!std::filesystem::exists(blockPath))
+    {
+        if (!GetCourseFilePath(filePath))
+        {
+            return;
+        }
+        if (!BuildBlockFile(filePath, blockPath))
+        {
+            std::cout << "Catalog is not valid, block file not built." << std::endl;
+            return;
+        }
+    }
+    if (blocks.Open(blockPath, cacheBlocks))
+    {
+        std::cout << "Catalog opened out of core: " << blocks.GetSize() << " courses in " << blocks.GetBlockCount()
+                  << " blocks." << std::endl;
+    }
+    else
+    {
+        std::cout << "Block file corrupt, rebuild it by deleting " << blockPath << "." << std::endl;
+    }
+}
+
+// Prints all courses of the block file in order, streaming its blocks (Case 2).
+// Parameters:
+//   blocks - Reference to the open BlockCatalog.
+void PrintCoursesInOrder(BST::BlockCatalog &blocks)
+{
+    blocks.PrintOrdered();
+    std::cout << "" << std::endl;
+    std::cout << "Courses: " << blocks.GetSize() << std::endl;
+    std::cout << "" << std::endl;
+}
+
+// Prints details of a specific course from the block file (Case 3).
+// Parameters:
+//   blocks - Reference to the open BlockCatalog.
+void PrintOneCourse(BST::BlockCatalog &blocks)
+{
+    std::string message = "Which course (by ID) would you like to know about?";
+    std::string userinput;
+
+    GetUserString(message, &userinput);
+    blocks.PrintSingleCourse(userinput);
+}
+
+// Prints all courses of the sharded catalog in order (Case 2).
+// Parameters:
+//   shards - Reference to the loaded ShardedCatalog.
+void PrintCoursesInOrder(BST::ShardedCatalog &shards)
+{
+    shards.PrintOrdered();
+    std::cout << "" << std::endl;
+    std::cout << "Courses: " << shards.GetSize() << std::endl;
+    std::cout << "" << std::endl;
+}
+
 // Prints details of a specific course based on user input (Case 3).
 // Parameters:
-//   tree - Reference to the BinarySearchTree containing course data.
-void PrintOneCourse(BST::BinarySearchTree &tree)
+//   shards - Reference to the loaded ShardedCatalog.
+void PrintOneCourse(BST::ShardedCatalog &shards)
+{
+    std::string message = "Which course (by ID) would you like to know about?";
+    std::string userinput;
+
+    GetUserString(message, &userinput);
+    shards.PrintSingleCourse(userinput);
+}
+
+// Prints the courses of one department, reading only its shard (Case 12).
+// Parameters:
+//   shards - Reference to the ShardedCatalog.
+void PrintDepartment(BST::ShardedCatalog &shards)
+{
+    if (shards.GetSize() == 0)
+    {
+        std::cout << "Department listings need the sharded catalog, start the app with --sharded." << std::endl;
+        return;
+    }
+    std::string message = "Which department would you like to list, e.g. CSCI or MATH?";
+    std::string userinput;
+
+    GetUserString(message, &userinput);
+    std::vector<Course> courses = shards.GetDepartment(userinput);
+    for (const Course &course : courses)
+    {
+        CourseTree::PrintIdDescription(course);
+    }
+    std::cout << "" << std::endl;
+    std::cout << "Courses: " << courses.size() << std::endl;
+    std::cout << "" << std::endl;
+}
+
+// Prints all courses of a mapped snapshot in order (Case 2).
+// Parameters:
+//   snapshot - Reference to the open MappedCatalog.
+void PrintCoursesInOrder(BST::MappedCatalog &snapshot)
+{
+    snapshot.PrintOrdered();
+    std::cout << "" << std::endl;
+    std::cout << "Courses: " << snapshot.GetSize() << std::endl;
+    std::cout << "" << std::endl;
+}
+
+// Prints details of a specific course based on user input (Case 3).
+// Parameters:
+//   snapshot - Reference to the open MappedCatalog.
+void PrintOneCourse(BST::MappedCatalog &snapshot)
+{
+    std::string message = "Which course (by ID) would you like to know about?";
+    std::string userinput;
+
+    GetUserString(message, &userinput);
+    snapshot.PrintSingleCourse(userinput);
+}
+
+// Prints all courses of the compiled-in catalog in order (Case 2).
+// Parameters:
+//   embedded - Reference to the open EmbeddedCatalog.
+void PrintCoursesInOrder(BST::EmbeddedCatalog &embedded)
+{
+    embedded.PrintOrdered();
+    std::cout << "" << std::endl;
+    std::cout << "Courses: " << embedded.GetSize() << std::endl;
+    std::cout << "" << std::endl;
+}
+
+// Prints details of a specific course from the compiled-in catalog (Case 3).
+// Parameters:
+//   embedded - Reference to the open EmbeddedCatalog.
+void PrintOneCourse(BST::EmbeddedCatalog &embedded)
+{
+    std::string message = "Which course (by ID) would you like to know about?";
+    std::string userinput;
+
+    GetUserString(message, &userinput);
+    embedded.PrintSingleCourse(userinput);
+}
+
+// Validates the loaded catalog and saves it as a binary snapshot (Case 4).
+// Parameters:
+//   tree - Reference to the CourseTree containing course data.
+void SaveCatalogSnapshot(BST::CourseTree &tree)
+{
+    if (tree.GetSize() == 0)
+    {
+        std::cout << "No courses found." << std::endl;
+        return;
+    }
+    if (!tree.ValidateCourses())
+    {
+        std::cout << "Catalog is not valid, snapshot not saved." << std::endl;
+        return;
+    }
+
+    std::string message = "Enter the file name for the snapshot (no extension).";
+    std::string userInput = "";
+    GetUserString(message, &userInput);
+    if (userInput.size() < 1)
+    {
+        std::cout << "Improper filename. Please try again." << std::endl;
+        return;
+    }
+    userInput += ".snap";
+
+    if (SaveSnapshot(userInput, tree))
+    {
+        std::cout << "Snapshot saved to " << userInput << "." << std::endl;
+    }
+    else
+    {
+        std::cout << "Snapshot failed to save." << std::endl;
+    }
+}
+
+// Prints details of a specific course based on user input (Case 3).
+// Parameters:
+//   tree - Reference to the CourseTree containing course data.
+void PrintOneCourse(BST::CourseTree &tree)
 {
     std::string message = "Which course (by ID) would you like to know about?";
     std::string userinput;
@@ -142,6 +743,135 @@ void PrintOneCourse(BST::BinarySearchTree &tree)
     tree.PrintSingleCourse(userinput);
 }
 
+// Asks for a page of the ordered course list by page number or by a course ID
+// on the page (Case 13).
+// Parameters:
+//   pageCount - Number of pages, shown in the prompt.
+//   courseId  - Receives the course ID if the user entered one instead of a number.
+// Returns: The page number entered, or 0 if the user entered a course ID.
+int GetUserPage(int pageCount, std::string *courseId)
+{
+    std::string message = "Which page (1 to " + std::to_string(pageCount) + ") or course ID would you like to see?";
+    std::string userinput;
+
+    GetUserString(message, &userinput);
+    if (userinput.empty() || !std::isdigit(static_cast<unsigned char>(userinput[0])))
+    {
+        *courseId = userinput;
+        return 0;
+    }
+    try
+    {
+        return std::stoi(userinput);
+    }
+    catch (const std::exception &e)
+    {
+        return -1; // Too large for any page, reported as not found.
+    }
+}
+
+// Prints one page of the ordered course list (Case 13). The user enters a page
+// number, or a course ID to jump to the page holding it, found by its rank.
+// Parameters:
+//   tree - Reference to the CourseTree containing course data.
+void PrintCoursePage(BST::CourseTree &tree)
+{
+    if (tree.GetSize() == 0)
+    {
+        std::cout << "No courses found." << std::endl;
+        return;
+    }
+    std::string courseId;
+    int page = GetUserPage((tree.GetSize() + COURSE_PAGE_SIZE - 1) / COURSE_PAGE_SIZE, &courseId);
+    if (page == 0)
+    {
+        if (tree.Find(courseId) == nullptr)
+        {
+            std::cout << "Course not found." << std::endl;
+            return;
+        }
+        page = tree.Rank(courseId) / COURSE_PAGE_SIZE + 1;
+    }
+    tree.PrintPage(page, COURSE_PAGE_SIZE);
+}
+
+// Prints one page of the out-of-core catalog's ordered list (Case 13), reading
+// only the blocks the page covers.
+// Parameters:
+//   blocks - Reference to the open BlockCatalog.
+void PrintCoursePage(BST::BlockCatalog &blocks)
+{
+    std::string courseId;
+    int page = GetUserPage((blocks.GetSize() + COURSE_PAGE_SIZE - 1) / COURSE_PAGE_SIZE, &courseId);
+    if (page == 0)
+    {
+        Course course;
+        uint64_t rank = 0;
+        if (!blocks.FindCourse(courseId, course) || !blocks.Rank(courseId, rank))
+        {
+            std::cout << "Course not found." << std::endl;
+            return;
+        }
+        page = static_cast<int>(rank / COURSE_PAGE_SIZE + 1);
+    }
+    blocks.PrintPage(page, COURSE_PAGE_SIZE);
+}
+
+// Finds courses by words in their names, based on user input (Case 7).
+// Parameters:
+//   tree - Reference to the CourseTree containing course data.
+void SearchCourseNames(BST::CourseTree &tree)
+{
+    if (tree.GetSize() == 0)
+    {
+        std::cout << "No courses found." << std::endl;
+        return;
+    }
+    std::string message = "Enter words from the course name, e.g. calculus or physics 2.";
+    std::string userinput;
+
+    GetUserString(message, &userinput);
+    tree.PrintNameSearch(userinput);
+}
+
+// Applies a delta file named by the user to the loaded catalog (Case 8).
+// Parameters:
+//   tree - Reference to the CourseTree containing course data.
+void ApplyCatalogDelta(BST::CourseTree &tree)
+{
+    if (tree.GetSize() == 0)
+    {
+        std::cout << "No courses found." << std::endl;
+        return;
+    }
+    std::string message = "Enter the file name for the delta (no extension).";
+    std::string userInput = "";
+    GetUserString(message, &userInput);
+    if (userInput.size() < 1)
+    {
+        std::cout << "Improper filename. Please try again." << std::endl;
+        return;
+    }
+    userInput += ".txt";
+    ReportDelta(userInput, ApplyDeltaFile(userInput, &tree));
+}
+
+// Prints the outcome of applying a delta file.
+// Parameters:
+//   filePath - The delta file.
+//   applied  - True if every change was applied.
+void ReportDelta(const std::string &filePath, bool applied)
+{
+    if (applied)
+    {
+        std::cout << "Delta " << filePath << " applied." << std::endl;
+    }
+    else
+    {
+        std::cout << "Delta " << filePath << " not applied, the catalog is unchanged." << std::endl;
+    }
+}
+
 // Prompts the user for a string input and stores it in the provided pointer.
 // Parameters:
 //   message - The prompt message displayed to the user.
@@ -168,7 +898,7 @@ void GetUserInt(int &input)
     }
     catch (const std::exception &e)
     {
-        input = 10; // Default value for invalid input.
+        input = -1; // Default value for invalid input, not a menu option.
     }
     BufferCheck(); // Clear input buffer to prevent errors.
 }
@@ -193,94 +923,18 @@ void OutputMenuItems()
     std::cout << "               1) Load Next 100 Courses to Memory" << std::endl;
     std::cout << "               2) Print Course List              " << std::endl;
     std::cout << "               3) Print Course                   " << std::endl;
-    std::cout << "               4) Exit                           " << std::endl;
+    std::cout << "               4) Save Catalog Snapshot          " << std::endl;
+    std::cout << "               5) Print Tree Statistics          " << std::endl;
+    std::cout << "               6) Print Latency Report           " << std::endl;
+    std::cout << "               7) Search Course Names            " << std::endl;
+    std::cout << "               8) Apply Delta File               " << std::endl;
+    std::cout << "               9) Load Whole Catalog in Background" << std::endl;
+    std::cout << "              10) Print Load Status              " << std::endl;
+    std::cout << "              11) Cancel Background Load         " << std::endl;
+    std::cout << "              12) Print Department Courses       " << std::endl;
+    std::cout << "              13) Print Course List Page         " << std::endl;
+    std::cout << "               0) Exit                           " << std::endl;
     std::cout << std::endl;
     std::cout << "-----------------------------------------------------------" << std::endl;
     std::cout << "-----------------------------------------------------------" << std::endl;
 }
-
-// Reads course data from a file and populates the Binary Search Tree.
-// Parameters:
-//   filepath      - The path to the file containing course data.
-//   tree          - Pointer to the BinarySearchTree to store the course data.
-// Returns: True if the file was successfully read and the tree was populated, false otherwise.
-bool ReadCourseFile(std::string filePath, BinarySearchTree *tree)
-{
-
-    if (!std::filesystem::exists(filePath))
-    {
-        std::cerr << "Error, File doesn't exist." << std::endl;
-        return false;
-    }
-
-    try
-    {
-        std::ifstream readfile(filePath);
-        std::string line;
-
-        // Check for file opening failure.
-        if (readfile.fail())
-        {
-            std::cout << std::endl;
-            std::cout << "            Failure to open a file of this name, please" << std::endl;
-            std::cout << "            make sure the file exists in programs directory." << std::endl;
-            std::cout << std::endl;
-            return false;
-        }
-
-        // Get next 100 courses
-
-        int starting = tree->GetSize();
-        int index = 0;
-        int ending = starting + 100;
-
-        // Read file line by line.
-        while (getline(readfile, line))
-        {
-            std::istringstream linestream(line);
-            std::vector<std::string> listOfPieces;
-            std::string piece;
-
-            // Parse line by commas.
-            while (getline(linestream, piece, ','))
-            {
-                listOfPieces.push_back(piece);
-            }
-
-            if (index >= starting && index < ending)
-            {
-                // Create a new Course object from parsed data.
-                Course *c = new Course();
-                if (listOfPieces.size() > 1)
-                {
-                    c->courseId = listOfPieces.at(0);
-                    c->courseName = listOfPieces.at(1);
-                }
-                for (size_t i = 2; i < listOfPieces.size(); i++)
-                {
-                    c->prereqs.push_back(listOfPieces.at(i));
-                }
-
-                // Insert course into the tree.
-                bool success = tree->Insert(*c);
-                if (!success)
-                {
-                    std::cout << "Not inserted: " << c->courseId << std::endl;
-                }
-                delete c; // Free allocated memory.
-            }
-
-            index++;
-        }
-    }
-    catch (std::ifstream::failure &e)
-    {
-        // Handle file reading errors.
-        std::cerr << "            Error opening/reading file." << std::endl;
-        return false;
-    }
-
-    // Validate all courses in the tree.
-    bool valid = tree->ValidateCourses();
-    return valid;
-}
@@ -11,6 +11,12 @@
 #include <string>
 #include <vector>
 #include "BST.hpp"
+#include "BackgroundLoader.hpp"
+#include "BlockCatalog.hpp"
+#include "CourseLoader.hpp"
+#include "EmbeddedCatalog.hpp"
+#include "ShardedCatalog.hpp"
+#include "Snapshot.hpp"
 
 // Prompts the user for an integer input and stores it in the provided reference.
 // Parameters:
@@ -19,18 +25,148 @@ void GetUserInt(int &userInput);
 
 // Builds a Binary Search Tree by reading course data from a file (Case 1).
 // Parameters:
-//   tree - Reference to the BinarySearchTree to populate with course data.
-void BuildStructureFromFile(std::string &filepath, BST::BinarySearchTree &courseTree);
+//   tree        - Reference to the CourseTree to populate with course data.
+//   loadThreads - Worker threads for loading the whole file, or -1 to load the next 100 courses.
+void BuildStructureFromFile(std::string &filepath, BST::CourseTree &courseTree, int loadThreads);
+
+// Asks the user for the course file unless the current path names an existing file.
+// Parameters:
+//   filePath - The course file path, replaced by the user's choice if needed.
+// Returns: True if there is a path to load, false if the user entered none.
+bool GetCourseFilePath(std::string &filePath);
+
+// Starts loading the whole course file in the background (Case 9).
+// Parameters:
+//   filePath - The course file, asked for if it does not exist.
+//   loader   - The background loader to start.
+void StartBackgroundLoad(std::string &filePath, BST::BackgroundLoader &loader);
+
+// Prints the progress of the background load with its rate and time left (Case 10).
+// Parameters:
+//   loader - The background loader to report on.
+void PrintLoadStatus(BST::BackgroundLoader &loader);
+
+// Hands a stopped background load's catalog to the tree, replacing any snapshot.
+// Parameters:
+//   loader   - The background loader that has stopped.
+//   tree     - The catalog to replace.
+//   snapshot - The mapped snapshot, closed once the tree takes over.
+//   shards   - The sharded catalog, cleared once the tree takes over.
+//   embedded - The compiled-in catalog, closed once the tree takes over.
+//   blocks   - The block file, closed once the tree takes over.
+void FinishBackgroundLoad(BST::BackgroundLoader &loader, BST::CourseTree &courseTree, BST::MappedCatalog &snapshot,
+                          BST::ShardedCatalog &shards, BST::EmbeddedCatalog &embedded, BST::BlockCatalog &blocks);
 
 // Prints the courses in the Binary Search Tree in ordered traversal (Case 2).
 // Parameters:
-//   tree - Reference to the BinarySearchTree containing course data.
-void PrintCoursesInOrder(BST::BinarySearchTree &courseTree);
+//   tree - Reference to the CourseTree containing course data.
+void PrintCoursesInOrder(BST::CourseTree &courseTree);
 
 // Prints details of a specific course from the Binary Search Tree (Case 3).
 // Parameters:
-//   tree - Reference to the BinarySearchTree containing course data.
-void PrintOneCourse(BST::BinarySearchTree &courseTree);
+//   tree - Reference to the CourseTree containing course data.
+void PrintOneCourse(BST::CourseTree &courseTree);
+
+// Prints all courses of a mapped snapshot in order (Case 2).
+// Parameters:
+//   snapshot - Reference to the open MappedCatalog.
+void PrintCoursesInOrder(BST::MappedCatalog &snapshot);
+
+// Prints details of a specific course from a mapped snapshot (Case 3).
+// Parameters:
+//   snapshot - Reference to the open MappedCatalog.
+void PrintOneCourse(BST::MappedCatalog &snapshot);
+
+// Prints all courses of the compiled-in catalog in order (Case 2).
+// Parameters:
+//   embedded - Reference to the open EmbeddedCatalog.
+void PrintCoursesInOrder(BST::EmbeddedCatalog &embedded);
+
+// Prints details of a specific course from the compiled-in catalog (Case 3).
+// Parameters:
+//   embedded - Reference to the open EmbeddedCatalog.
+void PrintOneCourse(BST::EmbeddedCatalog &embedded);
+
+// Loads the whole course file into the department-sharded catalog (--sharded).
+// Parameters:
+//   filePath    - The course file, asked for if it does not exist.
+//   shards      - The sharded catalog to replace.
+//   loadThreads - Worker threads, 0 to use every hardware thread.
+void BuildShardsFromFile(std::string &filePath, BST::ShardedCatalog &shards, int loadThreads);
+
+// Opens a block file to serve the catalog out of core (--blocks), building it
+// from the text catalog first if it does not exist.
+// Parameters:
+//   blockPath   - The block file.
+//   filePath    - The course file to build it from, asked for if it does not exist.
+//   blocks      - The block catalog to open.
+//   cacheBlocks - Blocks the cache holds.
+void OpenBlockFile(const std::string &blockPath, std::string &filePath, BST::BlockCatalog &blocks, size_t cacheBlocks);
+
+// Prints all courses of the block file in order, streaming its blocks (Case 2).
+// Parameters:
+//   blocks - Reference to the open BlockCatalog.
+void PrintCoursesInOrder(BST::BlockCatalog &blocks);
+
+// Prints details of a specific course from the block file (Case 3).
+// Parameters:
+//   blocks - Reference to the open BlockCatalog.
+void PrintOneCourse(BST::BlockCatalog &blocks);
+
+// Prints all courses of the sharded catalog in order (Case 2).
+// Parameters:
+//   shards - Reference to the loaded ShardedCatalog.
+void PrintCoursesInOrder(BST::ShardedCatalog &shards);
+
+// Prints details of a specific course from the sharded catalog (Case 3).
+// Parameters:
+//   shards - Reference to the loaded ShardedCatalog.
+void PrintOneCourse(BST::ShardedCatalog &shards);
+
+// Prints the courses of one department, reading only its shard (Case 12).
+// Parameters:
+//   shards - Reference to the ShardedCatalog.
+void PrintDepartment(BST::ShardedCatalog &shards);
+
+// Asks for a page of the ordered course list by page number or by a course ID
+// on the page (Case 13).
+// Parameters:
+//   pageCount - Number of pages, shown in the prompt.
+//   courseId  - Receives the course ID if the user entered one instead of a number.
+// Returns: The page number entered, or 0 if the user entered a course ID.
+int GetUserPage(int pageCount, std::string *courseId);
+
+// Prints one page of the ordered course list, chosen by page number or by a
+// course ID on the page (Case 13).
+// Parameters:
+//   tree - Reference to the CourseTree containing course data.
+void PrintCoursePage(BST::CourseTree &courseTree);
+
+// Prints one page of the block file's ordered course list (Case 13).
+// Parameters:
+//   blocks - Reference to the open BlockCatalog.
+void PrintCoursePage(BST::BlockCatalog &blocks);
+
+// Validates the loaded catalog and saves it as a binary snapshot (Case 4).
+// Parameters:
+//   tree - Reference to the CourseTree containing course data.
+void SaveCatalogSnapshot(BST::CourseTree &courseTree);
+
+// Finds courses by words in their names, based on user input (Case 7).
+// Parameters:
+//   tree - Reference to the CourseTree containing course data.
+void SearchCourseNames(BST::CourseTree &courseTree);
+
+// Applies a delta file named by the user to the loaded catalog (Case 8).
+// Parameters:
+//   tree - Reference to the CourseTree containing course data.
+void ApplyCatalogDelta(BST::CourseTree &courseTree);
+
+// Prints the outcome of applying a delta file.
+// Parameters:
+//   filePath - The delta file.
+//   applied  - True if every change was applied.
+void ReportDelta(const std::string &filePath, bool applied);
 
 // Prompts the user for a string input and stores it in the provided pointer.
 // Parameters:
@@ -43,10 +179,3 @@ void BufferCheck();
 
 // Displays the menu options for the ABCU application.
 void OutputMenuItems();
-
-// Reads course data from a file and populates the Binary Search Tree.
-// Parameters:
-//   filepath      - The path to the file containing course data.
-//   dataStructure - Pointer to the BinarySearchTree to store the course data.
-// Returns: True if the file was successfully read and the tree was populated, false otherwise.
-bool ReadCourseFile(std::string filepath, BST::BinarySearchTree *courseTree);
@@ -0,0 +1,1063 @@
+//============================================================================
+// Name        : ABCUBench.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Benchmark program for the ABCU Course App. Generates a synthetic
+//               course catalog, times every public tree operation and both
+//               loaders against it and writes the results, with latency
+//               percentiles per operation, as JSON so runs of different
+//               versions can be compared.
+//============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BackgroundLoader.hpp"
+#include "BlockCatalog.hpp"
+#include "BST.hpp"
+#include "CatalogGenerator.hpp"
+#include "CourseLoader.hpp"
+#include "EmbeddedCatalog.hpp"
+#include "PersistentTree.hpp"
+#include "ShardedCatalog.hpp"
+#include "Snapshot.hpp"
+#include "Latency.hpp"
+#ifdef ABCU_EMBEDDED_CATALOG
+#include "EmbeddedCourses.hpp"
+#endif
+
+using namespace BST;
+
+// Heap allocations made by the process, counted by the replacement operator new
+// below so every benchmark can report how many allocations it made.
+static std::atomic<uint64_t> allocationCount{0};
+
+// Bytes currently allocated through operator new, so a benchmark can report how
+// much memory the structure it built keeps.
+static std::atomic<int64_t> liveBytes{0};
+
+// Size of the header in front of each allocation recording its size. Sixteen
+// bytes keeps the memory handed out aligned as malloc aligned it.
+static const std::size_t allocationHeader = 16;
+
+// Replacement global allocation functions that count every allocation and the
+// bytes still allocated.
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size + allocationHeader))
+    {
+        *static_cast<std::size_t *>(memory) = size;
+        liveBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+        return static_cast<char *>(memory) + allocationHeader;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC pairs inlined copies of this with the new expressions that call the
+// replacement operator new, and wrongly reports malloc memory freed as new memory.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void *memory) noexcept
+{
+    if (memory == nullptr)
+    {
+        return;
+    }
+    void *block = static_cast<char *>(memory) - allocationHeader;
+    liveBytes.fetch_sub(static_cast<int64_t>(*static_cast<std::size_t *>(block)), std::memory_order_relaxed);
+    std::free(block);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    operator delete(memory);
+}
+
+// The nothrow forms, used by the standard library's temporary buffers, must go
+// through the same header or their blocks would be freed without one.
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return operator new(size);
+    }
+    catch (const std::bad_alloc &)
+    {
+        return nullptr;
+    }
+}
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept
+{
+    operator delete(memory);
+}
+
+// Timing of one benchmark.
+struct BenchResult
+{
+    std::string name;     // Name of the operation.
+    size_t operations;    // Number of operations timed.
+    double seconds;       // Total elapsed time.
+    uint64_t allocations; // Heap allocations made while timing.
+    int64_t bytes;        // Heap bytes still allocated after the job, less those before it.
+};
+
+// Times a job with console output switched off, since several of the measured
+// operations print every course.
+// Parameters:
+//   name       - Name of the operation.
+//   operations - Number of operations the job performs.
+//   job        - The work to time.
+// Returns: The timing, allocation count and heap growth of the job.
+template <typename Job>
+BenchResult Measure(const std::string &name, size_t operations, Job job)
+{
+    std::streambuf *console = std::cout.rdbuf(nullptr);
+    uint64_t allocationsBefore = allocationCount.load();
+    int64_t bytesBefore = liveBytes.load();
+    auto start = std::chrono::steady_clock::now();
+    job();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    uint64_t allocations = allocationCount.load() - allocationsBefore;
+    int64_t bytes = liveBytes.load() - bytesBefore;
+    std::cout.rdbuf(console);
+    std::cout.clear();
+    std::cerr << "  " << name << ": " << elapsed.count() << " s, " << allocations << " allocations, "
+              << bytes << " bytes kept" << std::endl;
+    return BenchResult{name, operations, elapsed.count(), allocations, bytes};
+}
+
+// Returns the case-insensitive edit distance between two IDs, the brute-force
+// baseline for the suggestion index.
+// Parameters:
+//   first, second - The IDs to compare.
+int EditDistance(const std::string &first, const std::string &second)
+{
+    std::vector<int> row(second.size() + 1);
+    for (size_t j = 0; j < row.size(); j++)
+    {
+        row[j] = static_cast<int>(j);
+    }
+    for (size_t i = 1; i <= first.size(); i++)
+    {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= second.size(); j++)
+        {
+            int above = row[j];
+            bool same = NoCaseCompare::Fold(first[i - 1]) == NoCaseCompare::Fold(second[j - 1]);
+            row[j] = std::min({row[j] + 1, row[j - 1] + 1, diagonal + (same ? 0 : 1)});
+            diagonal = above;
+        }
+    }
+    return row.back();
+}
+
+// Escapes text for use inside a JSON string: quotes and backslashes get a
+// backslash and control characters become \u escapes.
+// Parameters:
+//   text - The text to escape.
+// Returns: The escaped text, without surrounding quotes.
+std::string EscapeJson(const std::string &text)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char code[7];
+            std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned char>(c));
+            escaped += code;
+        }
+        else
+        {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+// Writes the benchmark results as a JSON document.
+// Parameters:
+//   out     - Stream to write to.
+//   label   - Free-form label of the build being measured, e.g. a version.
+//   options - Settings of the generated catalog.
+//   results - Timings to write. Latency percentiles are in nanoseconds.
+void WriteJson(std::ostream &out, const std::string &label, const GeneratorOptions &options,
+               const std::vector<BenchResult> &results)
+{
+    out << "{\n";
+    out << "  \"label\": \"" << EscapeJson(label) << "\",\n";
+    out << "  \"catalog\": {\"courses\": " << options.courseCount
+        << ", \"order\": \"" << KeyOrderName(options.order) << "\""
+        << ", \"idLength\": [" << options.minIdLength << ", " << options.maxIdLength << "]"
+        << ", \"nameLength\": [" << options.minNameLength << ", " << options.maxNameLength << "]"
+        << ", \"fanOut\": " << options.maxFanOut << ", \"depth\": " << options.maxDepth
+        << ", \"seed\": " << options.seed << "},\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchResult &result = results[i];
+        double nsPerOp = result.operations == 0 ? 0 : result.seconds * 1e9 / result.operations;
+        out << "    {\"name\": \"" << result.name << "\", \"operations\": " << result.operations
+            << ", \"seconds\": " << result.seconds << ", \"nsPerOp\": " << nsPerOp
+            << ", \"allocations\": " << result.allocations << ", \"bytes\": " << result.bytes << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"latency\": [\n";
+    for (int i = 0; i < static_cast<int>(LatencyOperation::Count); i++)
+    {
+        LatencyOperation operation = static_cast<LatencyOperation>(i);
+        const LatencyHistogram &histogram = GetLatencyHistogram(operation);
+        out << "    {\"name\": \"" << LatencyOperationName(operation) << "\", \"count\": " << histogram.GetCount()
+            << ", \"p50\": " << histogram.ValueAtPercentile(50) << ", \"p90\": " << histogram.ValueAtPercentile(90)
+            << ", \"p99\": " << histogram.ValueAtPercentile(99) << ", \"p99.9\": " << histogram.ValueAtPercentile(99.9)
+            << ", \"max\": " << histogram.GetMax() << "}"
+            << (i + 1 < static_cast<int>(LatencyOperation::Count) ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+// Benchmark entry point.
+// Parameters:
+//   argv - Generator flags (see ApplyGeneratorFlag), --label TEXT, --json FILE and
+//          --stress N to also insert N courses in sorted order and clear them.
+// Returns: 0 on success, 1 on a bad flag or a failed allocation, search or suggestion check.
+int main(int argc, char *argv[])
+{
+    GeneratorOptions options;
+    std::string label = "unlabelled";
+    std::string jsonPath = "";
+    size_t stressCount = 0;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string flag = argv[i];
+        if (flag == "--label")
+        {
+            label = argv[i + 1];
+        }
+        else if (flag == "--json")
+        {
+            jsonPath = argv[i + 1];
+        }
+        else if (flag == "--stress")
+        {
+            stressCount = std::stoul(argv[i + 1]);
+        }
+        else if (!ApplyGeneratorFlag(flag, argv[i + 1], options))
+        {
+            std::cerr << "Unknown flag or bad value: " << flag << " " << argv[i + 1] << std::endl;
+            return 1;
+        }
+    }
+
+    if (argc % 2 == 0 || options.courseCount == 0)
+    {
+        std::cerr << "Usage: ABCUBench [generator flags] [--label TEXT] [--json FILE] [--stress N], with at least one course." << std::endl;
+        return 1;
+    }
+
+    std::cerr << "Generating " << options.courseCount << " courses (" << KeyOrderName(options.order) << ")" << std::endl;
+    std::vector<Course> courses = GenerateCatalog(options);
+    std::string filePath = "BenchCatalog.txt";
+    WriteCatalogFile(filePath, courses);
+
+    std::mt19937_64 random(options.seed);
+    size_t lookups = std::min<size_t>(courses.size(), 10000);
+    std::vector<std::string> probes;
+    for (size_t i = 0; i < lookups; i++)
+    {
+        probes.push_back(courses[random() % courses.size()].courseId);
+    }
+
+    std::vector<BenchResult> results;
+    CourseTree tree;
+
+    results.push_back(Measure("Insert", courses.size(), [&]()
+                              {
+        for (const Course &course : courses)
+        {
+            tree.Insert(course);
+        } }));
+
+    // Moving a course in must allocate nothing but its node, and a rejected
+    // duplicate must allocate nothing and leave the course intact. Checked on the
+    // bare tree engine, since CourseTree also copies names into its name index.
+    bool checkFailed = false;
+    {
+        std::vector<Course> movable = courses;
+        BinarySearchTree<Course, CourseIdOf, NoCaseCompare> moveTree;
+        BenchResult moved = Measure("Insert/move", movable.size(), [&]()
+                                    {
+            for (Course &course : movable)
+            {
+                moveTree.Insert(std::move(course));
+            } });
+        if (moved.allocations != movable.size() || moveTree.GetSize() != static_cast<int>(movable.size()))
+        {
+            std::cerr << "  Insert/move: expected one allocation per course, got " << moved.allocations
+                      << " for " << movable.size() << std::endl;
+            checkFailed = true;
+        }
+        results.push_back(moved);
+
+        std::vector<Course> duplicates(courses.begin(), courses.begin() + probes.size());
+        size_t rejected = 0;
+        BenchResult duplicate = Measure("Insert/duplicate", duplicates.size(), [&]()
+                                        {
+            for (Course &course : duplicates)
+            {
+                rejected += moveTree.Insert(std::move(course)) ? 0 : 1;
+            } });
+        bool intact = std::equal(duplicates.begin(), duplicates.end(), courses.begin(), [](const Course &first, const Course &second)
+                                 { return first.courseId == second.courseId && first.courseName == second.courseName &&
+                                          first.prereqs == second.prereqs; });
+        if (duplicate.allocations != 0 || rejected != duplicates.size() || !intact)
+        {
+            std::cerr << "  Insert/duplicate: rejected courses must be left untouched without allocating" << std::endl;
+            checkFailed = true;
+        }
+        results.push_back(duplicate);
+    }
+
+    // Memory kept by the catalog with every ID and prerequisite as its own string,
+    // against the same courses holding handles into a string pool, and the whole
+    // CourseTree with its indexes for reference.
+    {
+        BinarySearchTree<Course, CourseIdOf, NoCaseCompare> plainTree;
+        results.push_back(Measure("Memory/strings", courses.size(), [&]()
+                                  {
+            for (const Course &course : courses)
+            {
+                plainTree.Insert(course);
+            } }));
+        StringPool pool;
+        BinarySearchTree<CatalogCourse, CatalogIdOf, NoCaseCompare> internedTree;
+        results.push_back(Measure("Memory/interned", courses.size(), [&]()
+                                  {
+            for (const Course &course : courses)
+            {
+                CatalogCourse stored{pool.Intern(course.courseId), course.courseName, {}};
+                stored.prereqs.reserve(course.prereqs.size());
+                for (const std::string &prereq : course.prereqs)
+                {
+                    stored.prereqs.push_back(pool.Intern(prereq));
+                }
+                internedTree.Insert(std::move(stored));
+            } }));
+        CourseTree fullTree;
+        results.push_back(Measure("Memory/CourseTree", courses.size(), [&]()
+                                  {
+            for (const Course &course : courses)
+            {
+                fullTree.Insert(course);
+            } }));
+    }
+
+    results.push_back(Measure("PrintSingleCourse", probes.size(), [&]()
+                              {
+        for (const std::string &probe : probes)
+        {
+            tree.PrintSingleCourse(probe);
+        } }));
+
+    // Name search through the trigram index against scanning every course.
+    // Queries are four characters from the end of random names, without spaces so
+    // the scan below can treat each one as a single word.
+    std::vector<std::string> nameQueries;
+    while (nameQueries.size() < std::min<size_t>(probes.size(), 200))
+    {
+        const std::string &name = courses[random() % courses.size()].courseName;
+        std::string query = name.substr(name.size() - std::min<size_t>(name.size(), 4));
+        if (query.find(' ') == std::string::npos)
+        {
+            nameQueries.push_back(query);
+        }
+    }
+    size_t indexedMatches = 0;
+    size_t scannedMatches = 0;
+    results.push_back(Measure("NameSearch/index", nameQueries.size(), [&]()
+                              {
+        for (const std::string &query : nameQueries)
+        {
+            indexedMatches += tree.SearchNames(query).size();
+        } }));
+    results.push_back(Measure("NameSearch/scan", nameQueries.size(), [&]()
+                              {
+        for (const std::string &query : nameQueries)
+        {
+            std::string folded = query;
+            std::transform(folded.begin(), folded.end(), folded.begin(), ::tolower);
+            tree.ForEachInOrder([&](const CatalogCourse &course)
+                                {
+                std::string name = course.courseName;
+                std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+                scannedMatches += name.find(folded) != std::string::npos ? 1 : 0; });
+        } }));
+    if (indexedMatches != scannedMatches)
+    {
+        std::cerr << "  NameSearch: index found " << indexedMatches << " matches, scan found " << scannedMatches << std::endl;
+        checkFailed = true;
+    }
+
+    // "Did you mean" suggestions for mistyped IDs through the index against
+    // measuring the distance to every ID. Each typo replaces one character.
+    std::vector<std::string> typos;
+    for (size_t i = 0; i < std::min<size_t>(probes.size(), 200); i++)
+    {
+        std::string typo = probes[i];
+        typo[random() % typo.size()] = '#';
+        typos.push_back(typo);
+    }
+    std::vector<std::vector<std::string>> indexedSuggestions;
+    results.push_back(Measure("Suggest/index", typos.size(), [&]()
+                              {
+        for (const std::string &typo : typos)
+        {
+            indexedSuggestions.push_back(tree.SuggestIds(typo));
+        } }));
+    size_t scannedTypos = std::min<size_t>(typos.size(), 20);
+    std::vector<std::vector<std::string>> scannedSuggestions;
+    results.push_back(Measure("Suggest/scan", scannedTypos, [&]()
+                              {
+        for (size_t i = 0; i < scannedTypos; i++)
+        {
+            std::vector<std::pair<int, std::string>> found;
+            for (int maxDistance = 1; maxDistance <= 2 && found.empty(); maxDistance++)
+            {
+                for (const Course &course : courses)
+                {
+                    int distance = EditDistance(typos[i], course.courseId);
+                    if (distance <= maxDistance)
+                    {
+                        found.emplace_back(distance, course.courseId);
+                    }
+                }
+            }
+            NoCaseCompare compare;
+            std::sort(found.begin(), found.end(), [&compare](const std::pair<int, std::string> &first, const std::pair<int, std::string> &second)
+                      { return first.first != second.first ? first.first < second.first : compare(first.second, second.second) < 0; });
+            std::vector<std::string> suggestions;
+            for (size_t j = 0; j < found.size() && j < 5; j++)
+            {
+                suggestions.push_back(found[j].second);
+            }
+            scannedSuggestions.push_back(suggestions);
+        } }));
+    if (!std::equal(scannedSuggestions.begin(), scannedSuggestions.end(), indexedSuggestions.begin()))
+    {
+        std::cerr << "  Suggest: the index and the scan disagree" << std::endl;
+        checkFailed = true;
+    }
+
+    // Changes in place: rename and remove a spread of courses, then add them back
+    // as one delta. Removed courses must vanish from the tree and both indexes,
+    // and the delta must restore the catalog.
+    {
+        size_t changeCount = std::min<size_t>(courses.size(), 1000);
+        size_t step = courses.size() / changeCount;
+        std::vector<Course> changed;
+        for (size_t i = 0; i < changeCount; i++)
+        {
+            changed.push_back(courses[i * step]);
+        }
+        results.push_back(Measure("Update", changed.size(), [&]()
+                                  {
+            for (Course course : changed)
+            {
+                course.courseName += " (revised)";
+                tree.Update(std::move(course));
+            } }));
+        results.push_back(Measure("Remove", changed.size(), [&]()
+                                  {
+            for (const Course &course : changed)
+            {
+                tree.Remove(course.courseId);
+            } }));
+        bool gone = std::all_of(changed.begin(), changed.end(), [&tree](const Course &course)
+                                { return tree.Find(course.courseId) == nullptr &&
+                                         tree.SuggestIds(course.courseId, 1) != std::vector<std::string>{course.courseId}; }) &&
+                    tree.SearchNames("(revised)").empty();
+        std::vector<CourseChange> delta;
+        for (const Course &course : changed)
+        {
+            delta.push_back(CourseChange{CourseChange::Kind::Add, course});
+        }
+        bool applied = false;
+        results.push_back(Measure("ApplyChanges", delta.size(), [&]()
+                                  { applied = tree.ApplyChanges(std::move(delta)); }));
+        if (!gone || !applied || tree.GetSize() != static_cast<int>(courses.size()))
+        {
+            std::cerr << "  Remove: removed courses were still found, or the delta did not restore them" << std::endl;
+            checkFailed = true;
+        }
+    }
+
+    results.push_back(Measure("PrintOrdered", courses.size(), [&]()
+                              { tree.PrintOrdered(); }));
+    results.push_back(Measure("ValidateCourses", courses.size(), [&]()
+                              { tree.ValidateCourses(); }));
+    results.push_back(Measure("RebalanceTree", courses.size(), [&]()
+                              { tree.RebalanceTree(); }));
+    results.push_back(Measure("Clear", courses.size(), [&]()
+                              { tree.Clear(); }));
+
+    // The serial loader takes 100 lines per call, as option 1 of the app does.
+    results.push_back(Measure("ReadCourseFile", courses.size(), [&]()
+                              {
+        int previous = -1;
+        while (tree.GetSize() != previous)
+        {
+            previous = tree.GetSize();
+            ReadCourseFile(filePath, &tree);
+        } }));
+    tree.Clear();
+
+    for (unsigned int threads : {1u, 2u, 4u, 8u, 16u})
+    {
+        CourseTree parallelTree;
+        results.push_back(Measure("ReadCourseFileParallel/" + std::to_string(threads), courses.size(), [&]()
+                                  { ReadCourseFileParallel(filePath, &parallelTree, threads); }));
+    }
+
+    // The background pipeline, parsing on one thread while inserting on another,
+    // up to the validated catalog being handed over.
+    {
+        CourseTree backgroundTree;
+        BackgroundLoader loader;
+        bool loaded = false;
+        results.push_back(Measure("ReadCourseFile/background", courses.size(), [&]()
+                                  { loaded = loader.Start(filePath) && loader.Finish(backgroundTree); }));
+        if (!loaded || backgroundTree.GetSize() != static_cast<int>(courses.size()))
+        {
+            std::cerr << "  ReadCourseFile/background: loaded " << backgroundTree.GetSize() << " of "
+                      << courses.size() << " courses" << std::endl;
+            checkFailed = true;
+        }
+    }
+
+    // The department-sharded catalog: build and validate on every thread count,
+    // department listings from one shard against filtering the whole tree, the
+    // merged listing, and lookups mixed with inserts from several threads against
+    // one tree behind a single lock.
+    {
+        BinarySearchTree<Course, CourseIdOf, NoCaseCompare> wholeTree;
+        for (const Course &course : courses)
+        {
+            wholeTree.Insert(course);
+        }
+        ShardedCatalog shards;
+        for (unsigned int threads : {1u, 2u, 4u, 8u})
+        {
+            results.push_back(Measure("Sharded/load/" + std::to_string(threads), courses.size(), [&]()
+                                      { ReadCourseFileSharded(filePath, &shards, threads); }));
+        }
+        for (unsigned int threads : {1u, 8u})
+        {
+            results.push_back(Measure("Sharded/validate/" + std::to_string(threads), courses.size(), [&]()
+                                      { shards.ValidateCourses(threads); }));
+        }
+
+        std::vector<std::string> departments;
+        for (size_t i = 0; i < 100; i++)
+        {
+            departments.push_back(DepartmentOf(courses[random() % courses.size()].courseId));
+        }
+        size_t shardListed = 0;
+        size_t scanListed = 0;
+        results.push_back(Measure("Sharded/department", departments.size(), [&]()
+                                  {
+            for (const std::string &department : departments)
+            {
+                shardListed += shards.GetDepartment(department).size();
+            } }));
+        results.push_back(Measure("Sharded/department-scan", departments.size(), [&]()
+                                  {
+            for (const std::string &department : departments)
+            {
+                wholeTree.ForEachInOrder([&](const Course &course)
+                                         { scanListed += DepartmentOf(course.courseId) == department ? 1 : 0; });
+            } }));
+
+        std::vector<Course> merged;
+        results.push_back(Measure("Sharded/merge", courses.size(), [&]()
+                                  { merged = shards.GetCoursesInOrder(); }));
+        std::vector<Course> ordered = wholeTree.GetInOrder();
+        bool sameOrder = std::equal(merged.begin(), merged.end(), ordered.begin(), ordered.end(),
+                                    [](const Course &first, const Course &second)
+                                    { return first.courseId == second.courseId; });
+        size_t suggestMismatches = 0;
+        results.push_back(Measure("Sharded/suggest", typos.size(), [&]()
+                                  {
+            for (size_t i = 0; i < typos.size(); i++)
+            {
+                suggestMismatches += shards.SuggestIds(typos[i]) == indexedSuggestions[i] ? 0 : 1;
+            } }));
+        if (shardListed != scanListed || !sameOrder || suggestMismatches != 0)
+        {
+            std::cerr << "  Sharded: department listings, the merged order or " << suggestMismatches
+                      << " suggestions disagree with the tree" << std::endl;
+            checkFailed = true;
+        }
+
+        // Eight threads each look up 20000 IDs and insert one new course per 20 lookups.
+        const size_t workers = 8;
+        const size_t lookupsPerWorker = 20000;
+        auto newCourse = [&](size_t worker, size_t i)
+        {
+            Course course = courses[(worker * lookupsPerWorker + i) % courses.size()];
+            course.courseId += "-" + std::to_string(worker) + "-" + std::to_string(i);
+            return course;
+        };
+        BinarySearchTree<Course, CourseIdOf, NoCaseCompare> &lockedTree = wholeTree;
+        std::shared_mutex treeLock;
+        results.push_back(Measure("Concurrent/one-lock", workers * lookupsPerWorker, [&]()
+                                  {
+            std::vector<std::thread> threads;
+            for (size_t w = 0; w < workers; w++)
+            {
+                threads.emplace_back([&, w]()
+                                     {
+                    Course copy;
+                    for (size_t i = 0; i < lookupsPerWorker; i++)
+                    {
+                        if (i % 20 == 0)
+                        {
+                            std::unique_lock<std::shared_mutex> lock(treeLock);
+                            lockedTree.Insert(newCourse(w, i));
+                        }
+                        std::shared_lock<std::shared_mutex> lock(treeLock);
+                        Course *found = lockedTree.Find(probes[(w * 7919 + i) % probes.size()]);
+                        if (found != nullptr)
+                        {
+                            copy = *found;
+                        }
+                    } });
+            }
+            for (std::thread &thread : threads)
+            {
+                thread.join();
+            } }));
+        results.push_back(Measure("Concurrent/sharded", workers * lookupsPerWorker, [&]()
+                                  {
+            std::vector<std::thread> threads;
+            for (size_t w = 0; w < workers; w++)
+            {
+                threads.emplace_back([&, w]()
+                                     {
+                    Course copy;
+                    for (size_t i = 0; i < lookupsPerWorker; i++)
+                    {
+                        if (i % 20 == 0)
+                        {
+                            shards.Insert(newCourse(w, i));
+                        }
+                        shards.Find(probes[(w * 7919 + i) % probes.size()], &copy);
+                    } });
+            }
+            for (std::thread &thread : threads)
+            {
+                thread.join();
+            } }));
+        if (shards.GetSize() != lockedTree.GetSize())
+        {
+            std::cerr << "  Concurrent: the sharded catalog holds " << shards.GetSize() << " courses, the locked tree "
+                      << lockedTree.GetSize() << std::endl;
+            checkFailed = true;
+        }
+    }
+
+    // Pagination: streaming a page from a start found by the subtree counts,
+    // against walking the listing from the first course up to the page.
+    {
+        CourseTree pageTree;
+        ReadCourseFileParallel(filePath, &pageTree, 0);
+        const int pageSize = 20;
+        std::vector<int> pageStarts;
+        for (int i = 0; i < 200; i++)
+        {
+            pageStarts.push_back(static_cast<int>(random() % pageTree.GetSize()));
+        }
+        size_t selectHash = 0;
+        size_t walkHash = 0;
+        results.push_back(Measure("Page/select", pageStarts.size(), [&]()
+                                  {
+            for (int first : pageStarts)
+            {
+                pageTree.ForEachInRange(first, pageSize, [&](const CatalogCourse &course)
+                                        { selectHash = selectHash * 31 + std::hash<std::string_view>()(course.courseId->text); });
+            } }));
+        results.push_back(Measure("Page/walk", pageStarts.size(), [&]()
+                                  {
+            for (int first : pageStarts)
+            {
+                int position = 0;
+                pageTree.ForEachInOrder([&](const CatalogCourse &course)
+                                        {
+                    if (position >= first && position < first + pageSize)
+                    {
+                        walkHash = walkHash * 31 + std::hash<std::string_view>()(course.courseId->text);
+                    }
+                    position++; });
+            } }));
+        int rankMisses = 0;
+        results.push_back(Measure("Rank/select", probes.size(), [&]()
+                                  {
+            for (const std::string &probe : probes)
+            {
+                CatalogCourse *course = pageTree.Select(pageTree.Rank(probe));
+                rankMisses += course == nullptr || NoCaseCompare()(course->courseId->text, probe) != 0 ? 1 : 0;
+            } }));
+        if (selectHash != walkHash || rankMisses != 0)
+        {
+            std::cerr << "  Page: pages from Select differ from the ordered walk, or "
+                      << rankMisses << " IDs did not round trip through Rank and Select" << std::endl;
+            checkFailed = true;
+        }
+    }
+
+    // Out of core: building a block file with several sorted runs, then lookups
+    // and pages read through the block cache, warm and with a single block.
+    {
+        std::string blockPath = "BenchCatalog.blk";
+        CourseTree blockTree;
+        ReadCourseFileParallel(filePath, &blockTree, 0);
+        size_t runCourses = std::max<size_t>(1, courses.size() / 4);
+        bool built = false;
+        results.push_back(Measure("Blocks/build", courses.size(), [&]()
+                                  { built = BuildBlockFile(filePath, blockPath, runCourses); }));
+        int blockMismatches = built ? 0 : 1;
+        for (size_t cacheBlocks : {DEFAULT_CACHE_BLOCKS, static_cast<size_t>(1)})
+        {
+            BlockCatalog blocks;
+            blockMismatches += blocks.Open(blockPath, cacheBlocks) ? 0 : 1;
+            std::string suffix = cacheBlocks == 1 ? "-cold" : "";
+            results.push_back(Measure("Blocks/lookup" + suffix, probes.size(), [&]()
+                                      {
+                for (const std::string &probe : probes)
+                {
+                    blocks.PrintSingleCourse(probe);
+                } }));
+            BlockCacheStats stats = blocks.GetCacheStats();
+            std::cerr << "    " << 100.0 * stats.hits / std::max<uint64_t>(1, stats.blockReads) << "% cache hits, "
+                      << stats.bytesRead / std::max<uint64_t>(1, stats.queries) << " bytes read per lookup" << std::endl;
+            blocks.ResetCacheStats();
+            results.push_back(Measure("Blocks/page" + suffix, 200, [&]()
+                                      {
+                for (int page = 0; page < 200; page++)
+                {
+                    blocks.PrintPage(static_cast<int>(random() % (blocks.GetSize() / 20 + 1)) + 1, 20);
+                } }));
+            stats = blocks.GetCacheStats();
+            std::cerr << "    " << 100.0 * stats.hits / std::max<uint64_t>(1, stats.blockReads) << "% cache hits, "
+                      << stats.bytesRead / std::max<uint64_t>(1, stats.queries) << " bytes read per page" << std::endl;
+
+            blockMismatches += blocks.GetSize() == blockTree.GetSize() ? 0 : 1;
+            std::vector<Course> blockCourses = blocks.GetCoursesInRange(0, blocks.GetSize());
+            std::vector<Course> treeCourses = blockTree.GetCoursesInOrder();
+            for (size_t i = 0; i < blockCourses.size() && i < treeCourses.size(); i++)
+            {
+                blockMismatches += blockCourses[i].courseId == treeCourses[i].courseId &&
+                                           blockCourses[i].prereqs == treeCourses[i].prereqs
+                                       ? 0
+                                       : 1;
+            }
+            for (const std::string &probe : probes)
+            {
+                Course found;
+                bool inBlocks = blocks.FindCourse(probe, found);
+                blockMismatches += inBlocks == (blockTree.Find(probe) != nullptr) ? 0 : 1;
+                uint64_t rank = 0;
+                blockMismatches += blocks.Rank(probe, rank) && static_cast<int>(rank) == blockTree.Rank(probe) ? 0 : 1;
+            }
+            for (const std::string &typo : typos)
+            {
+                blockMismatches += blocks.SuggestIds(typo) == blockTree.SuggestIds(typo) ? 0 : 1;
+            }
+        }
+
+        // Headers claiming a directory past the end of the file, or too short for
+        // its blocks, must be rejected before anything is allocated from them.
+        std::string badPath = "BenchCatalog.bad.blk";
+        int badHeadersOpened = 0;
+        for (int corruption = 0; corruption < 3; corruption++)
+        {
+            std::ifstream in(blockPath, std::ios::binary);
+            std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            BlockFileHeader header;
+            std::memcpy(&header, bytes.data(), sizeof(header));
+            if (corruption == 0)
+            {
+                header.directoryLength = 1ULL << 62;
+            }
+            else if (corruption == 1)
+            {
+                header.directoryOffset = ~0ULL - 8;
+            }
+            else
+            {
+                header.blockCount = ~0U;
+            }
+            std::memcpy(bytes.data(), &header, sizeof(header));
+            std::ofstream(badPath, std::ios::binary | std::ios::trunc) << bytes;
+            BlockCatalog bad;
+            badHeadersOpened += bad.Open(badPath) ? 1 : 0;
+        }
+        std::remove(badPath.c_str());
+
+        if (blockMismatches != 0 || badHeadersOpened != 0)
+        {
+            std::cerr << "  Blocks: " << blockMismatches << " courses, lookups, ranks or suggestions differ from the tree, "
+                      << badHeadersOpened << " corrupt headers were accepted" << std::endl;
+            checkFailed = true;
+        }
+        std::remove(blockPath.c_str());
+    }
+
+    // Startup to first answered lookup: full text load against mapping a snapshot.
+    std::string snapshotPath = "BenchCatalog.snap";
+    {
+        CourseTree snapshotTree;
+        ReadCourseFileParallel(filePath, &snapshotTree, 0);
+        SaveSnapshot(snapshotPath, snapshotTree);
+    }
+    results.push_back(Measure("Startup/text", 1, [&]()
+                              {
+        CourseTree startupTree;
+        ReadCourseFileParallel(filePath, &startupTree, 0);
+        startupTree.PrintSingleCourse(probes.front()); }));
+    results.push_back(Measure("Startup/snapshot", 1, [&]()
+                              {
+        MappedCatalog snapshot;
+        snapshot.Open(snapshotPath);
+        snapshot.PrintSingleCourse(probes.front()); }));
+
+#ifdef ABCU_EMBEDDED_CATALOG
+    // Startup from the compiled-in catalog against loading the same courses from
+    // text. The loaded tree is kept, so bytes shows the heap the runtime loader
+    // needs and the embedded catalog does not.
+    {
+        std::string embeddedPath = "BenchCatalog.embedded.txt";
+        {
+            std::ofstream out(embeddedPath, std::ios::trunc);
+            for (const EmbeddedCourse &course : EMBEDDED_COURSES)
+            {
+                out << course.courseId << "," << course.courseName;
+                for (uint32_t i = 0; i < course.prereqCount; i++)
+                {
+                    out << "," << EMBEDDED_COURSES[EMBEDDED_PREREQS[course.firstPrereq + i]].courseId;
+                }
+                out << "\n";
+            }
+        }
+        std::string firstId(EMBEDDED_COURSES[EMBEDDED_COURSE_COUNT / 2].courseId);
+        CourseTree textTree;
+        results.push_back(Measure("Startup/embedded-text", 1, [&]()
+                                  {
+            ReadCourseFileParallel(embeddedPath, &textTree, 0);
+            textTree.PrintSingleCourse(firstId); }));
+        EmbeddedCatalog embedded;
+        results.push_back(Measure("Startup/embedded", 1, [&]()
+                                  {
+            embedded.Open();
+            embedded.PrintSingleCourse(firstId); }));
+        int mismatches = textTree.GetSize() == embedded.GetSize() ? 0 : 1;
+        textTree.ForEachInOrder([&](const CatalogCourse &course)
+                                {
+            const EmbeddedCourse *found = embedded.Find(course.courseId->text);
+            mismatches += found == nullptr || found->courseName != course.courseName ? 1 : 0; });
+        for (const std::string &typo : typos)
+        {
+            mismatches += embedded.SuggestIds(typo) == textTree.SuggestIds(typo) ? 0 : 1;
+        }
+        if (mismatches != 0)
+        {
+            std::cerr << "  Embedded: " << mismatches << " courses or suggestions differ from the same catalog loaded from text" << std::endl;
+            checkFailed = true;
+        }
+        std::remove(embeddedPath.c_str());
+    }
+#endif
+
+    // Key comparison alone: the old copy-and-lowercase comparison against the
+    // compile-time case-insensitive policy the tree now uses.
+    size_t comparisons = probes.size() * 100;
+    volatile int sink = 0;
+    results.push_back(Measure("Compare/copy", comparisons, [&]()
+                              {
+        for (size_t i = 0; i < comparisons; i++)
+        {
+            std::string first = probes[i % probes.size()];
+            std::string second = probes[(i * 7 + 1) % probes.size()];
+            std::transform(first.begin(), first.end(), first.begin(), ::tolower);
+            std::transform(second.begin(), second.end(), second.begin(), ::tolower);
+            sink = sink + first.compare(second);
+        } }));
+    results.push_back(Measure("Compare/NoCaseCompare", comparisons, [&]()
+                              {
+        NoCaseCompare compare;
+        for (size_t i = 0; i < comparisons; i++)
+        {
+            sink = sink + compare(probes[i % probes.size()], probes[(i * 7 + 1) % probes.size()]);
+        } }));
+
+    // Versioned catalog: stage 100 versions of 10 changes each on top of the
+    // loaded one, keeping every version, then list what changed between the first
+    // and the last. The diff skips the subtrees the versions share and must agree
+    // with merging the full contents of both.
+    {
+        using CourseVersion = PersistentTree<Course, CourseIdOf, NoCaseCompare>;
+        NoCaseCompare compare;
+        std::vector<Course> sorted = courses;
+        std::sort(sorted.begin(), sorted.end(), [&compare](const Course &first, const Course &second)
+                  { return compare(first.courseId, second.courseId) < 0; });
+        std::vector<CourseVersion> versions(1);
+        versions[0].BuildFromSorted(sorted);
+
+        size_t versionCount = 100;
+        size_t changesPerVersion = 10;
+        results.push_back(Measure("Persistent/stage", versionCount * changesPerVersion, [&]()
+                                  {
+            for (size_t v = 0; v < versionCount; v++)
+            {
+                CourseVersion next = versions.back();
+                for (size_t i = 0; i < changesPerVersion; i++)
+                {
+                    const Course &picked = sorted[random() % sorted.size()];
+                    if (i % 3 == 0)
+                    {
+                        next.Remove(picked.courseId);
+                    }
+                    else if (i % 3 == 1)
+                    {
+                        Course added = picked;
+                        added.courseId += "V" + std::to_string(v);
+                        next.Insert(std::move(added));
+                    }
+                    else
+                    {
+                        Course changed = picked;
+                        changed.courseName += " (revised)";
+                        next.Update(std::move(changed));
+                    }
+                }
+                versions.push_back(next);
+            } }));
+
+        size_t added = 0, removed = 0, changed = 0;
+        results.push_back(Measure("Persistent/diff", 1, [&]()
+                                  { CourseVersion::Diff(versions.front(), versions.back(), [&](const Course &)
+                                                        { added++; }, [&](const Course &)
+                                                        { removed++; }, [&](const Course &, const Course &)
+                                                        { changed++; }); }));
+
+        size_t fullAdded = 0, fullRemoved = 0, fullChanged = 0;
+        results.push_back(Measure("Persistent/diff-full", 1, [&]()
+                                  {
+            std::vector<const Course *> before, after;
+            versions.front().ForEachInOrder([&before](const Course &course)
+                                            { before.push_back(&course); });
+            versions.back().ForEachInOrder([&after](const Course &course)
+                                           { after.push_back(&course); });
+            size_t i = 0, j = 0;
+            while (i < before.size() || j < after.size())
+            {
+                int result = i == before.size() ? 1 : j == after.size() ? -1
+                                                                        : compare(before[i]->courseId, after[j]->courseId);
+                if (result < 0)
+                {
+                    fullRemoved++;
+                    i++;
+                }
+                else if (result > 0)
+                {
+                    fullAdded++;
+                    j++;
+                }
+                else
+                {
+                    fullChanged += before[i]->courseName != after[j]->courseName ? 1 : 0;
+                    i++;
+                    j++;
+                }
+            } }));
+        // Lookups run on a const version, as readers holding a published one would.
+        const CourseVersion &first = versions.front();
+        size_t firstFound = 0;
+        results.push_back(Measure("Persistent/lookup", probes.size(), [&]()
+                                  {
+            for (const std::string &probe : probes)
+            {
+                firstFound += first.Find(probe) != nullptr ? 1 : 0;
+            } }));
+
+        std::cerr << "  Persistent: " << versions.size() << " versions, " << added << " added, " << removed
+                  << " removed, " << changed << " changed" << std::endl;
+        if (added != fullAdded || removed != fullRemoved || changed != fullChanged ||
+            first.GetSize() != static_cast<int>(sorted.size()) || firstFound != probes.size())
+        {
+            std::cerr << "  Persistent: the diff and the full comparison disagree, or the first version changed" << std::endl;
+            checkFailed = true;
+        }
+    }
+
+    // Sorted inserts are the worst case for an unbalanced tree; with iterative
+    // algorithms and incremental balancing they must neither stall nor overflow the stack.
+    if (stressCount > 0)
+    {
+        CourseTree stressTree;
+        results.push_back(Measure("StressSortedInsert", stressCount, [&]()
+                                  {
+            Course course;
+            course.courseName = "Stress course";
+            char id[32];
+            for (size_t i = 0; i < stressCount; i++)
+            {
+                std::snprintf(id, sizeof(id), "S%012zu", i);
+                course.courseId = id;
+                stressTree.Insert(course);
+            } }));
+        std::cerr << "  StressSortedInsert height: " << stressTree.GetStats().height << std::endl;
+        results.push_back(Measure("StressClear", stressCount, [&]()
+                                  { stressTree.Clear(); }));
+    }
+
+    if (jsonPath.empty())
+    {
+        WriteJson(std::cout, label, options, results);
+    }
+    else
+    {
+        std::ofstream out(jsonPath);
+        WriteJson(out, label, options, results);
+    }
+    return checkFailed ? 1 : 0;
+}
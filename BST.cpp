@@ -2,222 +2,343 @@
 // Name        : BST.cpp
 // Author      : Shannon Musgrave
 // Version     : 1.0
-// Description : Implementation file for the Binary Search Tree (BST) used in the
-//               ABCU Course App. Defines methods for the Node and BinarySearchTree
-//               classes to manage course data, including insertion, deletion,
-//               printing, and validation of courses and their prerequisites.
+// Description : Implementation file for the course tree used in the ABCU Course
+//               App. The generic BinarySearchTree engine lives in BST.hpp; this
+//               file defines the CourseTree methods for printing, timing and
+//               validation of courses and their prerequisites, and the conversion
+//               between Course and the interned CatalogCourse the tree stores.
 //============================================================================
 
 #include "BST.hpp"
+#include "Latency.hpp"
 #include <algorithm>
 #include <iostream>
 #include <vector>
-#include <cmath>
 
 namespace BST
 {
 
-    // Node class implementation.
+    // CourseTree class implementation.
 
-    // Constructor: Initializes a node with a given course.
+    // Interns the ID and prerequisites of a course.
     // Parameters:
-    //   course - The Course object to store in the node.
-    Node::Node(Course course) : currentCourse(course)
+    //   course - The course to convert.
+    //   name   - The course name, copied or moved from the course by the caller.
+    // Returns: The course as the tree stores it.
+    CatalogCourse CourseTree::ToCatalogCourse(const Course &course, std::string name)
     {
-        // left and right are automatically initialized to nullptr by unique_ptr.
-    }
-
-    // Returns a raw pointer to the left child node.
-    // Returns: Raw pointer to the left child node, or nullptr if none exists.
-    Node *Node::GetLeft()
-    {
-        return this->leftTree.get();
-    }
-
-    // Returns a raw pointer to the right child node.
-    // Returns: Raw pointer to the right child node, or nullptr if none exists.
-    Node *Node::GetRight()
-    {
-        return this->rightTree.get();
+        CatalogCourse stored{this->strings.Intern(course.courseId), std::move(name), {}};
+        stored.prereqs.reserve(course.prereqs.size());
+        for (const std::string &prereq : course.prereqs)
+        {
+            stored.prereqs.push_back(this->strings.Intern(prereq));
+        }
+        return stored;
     }
 
-    // Sets the left child node.
+    // Copies a stored course back out as a Course.
     // Parameters:
-    //   node - Unique pointer to the new left child node.
-    void Node::SetLeft(std::unique_ptr<Node> node)
+    //   course - The stored course.
+    // Returns: The course with its ID and prerequisites as strings.
+    Course CourseTree::ToCourse(const CatalogCourse &course)
     {
-        this->leftTree = std::move(node);
+        Course copy{course.courseId->text, course.courseName, {}};
+        copy.prereqs.reserve(course.prereqs.size());
+        for (StringHandle prereq : course.prereqs)
+        {
+            copy.prereqs.push_back(prereq->text);
+        }
+        return copy;
     }
 
-    // Sets the right child node.
+    // Inserts a course if its ID is unique. A duplicate is found from the flag on
+    // the ID's handle without searching the tree, and is left untouched.
     // Parameters:
-    //   node - Unique pointer to the new right child node.
-    void Node::SetRight(std::unique_ptr<Node> node)
-    {
-        this->rightTree = std::move(node);
-    }
-
-    // Resets the left child node to nullptr.
-    void Node::ResetLeft()
+    //   course - The course to insert, copied from or moved from.
+    // Returns: True if insertion is successful, false if the course ID already exists.
+    template <typename CourseRef>
+    bool CourseTree::InsertCourse(CourseRef &&course)
     {
-        this->leftTree.reset();
-    }
+        ScopedLatency timer(LatencyOperation::Insert);
+        StringHandle existing = this->strings.Find(course.courseId);
+        if (existing != nullptr && existing->inCatalog)
+        {
+            return false;
+        }
+        CatalogCourse stored = this->ToCatalogCourse(course, std::forward<CourseRef>(course).courseName);
 
-    // Resets the right child node to nullptr.
-    void Node::ResetRight()
-    {
-        this->rightTree.reset();
-    }
+        // The course's own spelling wins over a prerequisite reference seen first.
+        std::copy(course.courseId.begin(), course.courseId.end(), stored.courseId->text.begin());
+        stored.courseId->inCatalog = true;
 
-    // Returns a pointer to the course stored in the node.
-    Course *Node::ReturnCourse()
-    {
-        return &this->currentCourse;
+        this->nameIndex.Add(stored.courseId->text, stored.courseName);
+        this->suggestionIndex.Add(stored.courseId->text);
+        if (this->dependentsBuilt)
+        {
+            this->AddDependents(stored);
+        }
+        return BinarySearchTree::Insert(std::move(stored));
     }
 
-    // BinarySearchTree class implementation.
-
-    // Constructor: Initializes an empty Binary Search Tree.
-    BinarySearchTree::BinarySearchTree()
+    // Inserts a copy of a course into the tree if its ID is unique.
+    // Parameters:
+    //   course - The Course object to insert.
+    // Returns: True if insertion is successful, false if the course ID already exists or insertion fails.
+    bool CourseTree::Insert(const Course &course)
     {
-        this->size = 0; // Initialize size to 0.
+        return this->InsertCourse(course);
     }
 
-    // Returns the number of courses in the tree.
-    // Returns: The size of the tree.
-    int BinarySearchTree::GetSize()
+    // Moves a course into the tree if its ID is unique.
+    // Parameters:
+    //   course - The Course object to insert, left untouched if the ID already exists.
+    // Returns: True if insertion is successful, false if the course ID already exists or insertion fails.
+    bool CourseTree::Insert(Course &&course)
     {
-        return this->size;
+        return this->InsertCourse(std::move(course));
     }
 
-    // Compares two strings case-insensitively after converting them to lowercase.
+    // Removes a course and its index entries.
     // Parameters:
-    //   first  - First string to compare.
-    //   second - Second string to compare.
-    // Returns: Integer (<0 if first < second, 0 if equal, >0 if first > second).
-    int BinarySearchTree::CompareNoCase(std::string first, std::string second)
+    //   courseId - ID of the course to remove.
+    //   removed  - If not nullptr, receives the removed course.
+    // Returns: True if the course was removed, false if it does not exist.
+    bool CourseTree::Remove(const std::string &courseId, Course *removed)
     {
-        std::transform(first.begin(), first.end(), first.begin(), ::tolower);
-        std::transform(second.begin(), second.end(), second.begin(), ::tolower);
-        return first.compare(second);
+        ScopedLatency timer(LatencyOperation::Remove);
+        StringHandle handle = this->strings.Find(courseId);
+        if (handle == nullptr || !handle->inCatalog)
+        {
+            return false;
+        }
+        this->nameIndex.Remove(handle->text);
+        this->suggestionIndex.Remove(handle->text);
+        CatalogCourse stored;
+        BinarySearchTree::Remove(handle->text, &stored);
+        if (this->dependentsBuilt)
+        {
+            this->RemoveDependents(stored);
+        }
+        // The pooled ID stays, other courses may still list it as a prerequisite.
+        handle->inCatalog = false;
+        if (removed != nullptr)
+        {
+            *removed = ToCourse(stored);
+        }
+        return true;
     }
 
-    // Inserts a new course into the tree if its ID is unique.
+    // Replaces the name and prerequisites of a course, keeping its indexes in step.
     // Parameters:
-    //   course - The Course object to insert.
-    // Returns: True if insertion is successful, false if the course ID already exists or insertion fails.
-    bool BinarySearchTree::Insert(Course course)
+    //   course - The new contents, found by course ID.
+    // Returns: True if the course was updated, false if it does not exist.
+    bool CourseTree::Update(Course course)
     {
-        // Check if course ID is unique
-        if (!this->IsCourseIdUnique(course))
+        ScopedLatency timer(LatencyOperation::Update);
+        StringHandle handle = this->strings.Find(course.courseId);
+        CatalogCourse *current = handle != nullptr && handle->inCatalog ? this->Find(handle->text) : nullptr;
+        if (current == nullptr)
         {
             return false;
         }
-
-        // If tree is empty, set the root node.
-        if (this->root == nullptr)
+        CatalogCourse stored = this->ToCatalogCourse(course, std::move(course.courseName));
+        this->nameIndex.Update(handle->text, stored.courseName);
+        if (this->dependentsBuilt)
         {
-            this->root = std::make_unique<Node>(course);
-            this->size++;
-            return true;
-        }
-
-        // Otherwise, recursively add the node.
-        int oldSize = this->size;
-        this->AddNode(this->root.get(), course);
-
-        // Rebalancing logic 
-        // Tree of sufficient size, once in 100 insertions, and is imbalanced.
-        bool isModded = this->size % 100 == 0;
-        if(this->size > 500 && isModded && IsImbalanced()){
-            this->RebalanceTree();
+            this->RemoveDependents(*current);
+            this->AddDependents(stored);
         }
-        return this->size > oldSize; // Return true if size increased.
+        *current = std::move(stored);
+        return true;
     }
 
-    // Recursively adds a node with the given course to the tree.
+    // Applies a list of changes as one unit, undoing them all if any fails.
     // Parameters:
-    //   node   - Pointer to the current node in the recursive traversal.
-    //   course - The Course object to insert.
-    void BinarySearchTree::AddNode(Node *node, Course course)
+    //   changes - The changes in the order to apply them.
+    // Returns: True if every change was applied and the result is valid.
+    bool CourseTree::ApplyChanges(std::vector<CourseChange> changes)
     {
-        if (!node)
-            return; // Defensive check, should not occur in normal usage.
+        std::vector<CourseChange> undo; // Reverse of each applied change, newest last.
+        std::vector<std::string> changedIds;
+        std::vector<std::string> removedIds;
+        bool applied = true;
+        for (CourseChange &change : changes)
+        {
+            std::string courseId = change.course.courseId;
+            if (change.kind == CourseChange::Kind::Add)
+            {
+                applied = this->Insert(std::move(change.course));
+                if (!applied)
+                {
+                    std::cout << "Not inserted: " << courseId << std::endl;
+                    break;
+                }
+                undo.push_back(CourseChange{CourseChange::Kind::Remove, Course{courseId, "", {}}});
+                changedIds.push_back(courseId);
+            }
+            else if (change.kind == CourseChange::Kind::Remove)
+            {
+                Course removed;
+                applied = this->Remove(courseId, &removed);
+                if (!applied)
+                {
+                    std::cout << "Not removed: " << courseId << std::endl;
+                    break;
+                }
+                undo.push_back(CourseChange{CourseChange::Kind::Add, std::move(removed)});
+                removedIds.push_back(courseId);
+            }
+            else
+            {
+                CatalogCourse *current = this->Find(courseId);
+                applied = current != nullptr;
+                if (!applied)
+                {
+                    std::cout << "Not modified: " << courseId << std::endl;
+                    break;
+                }
+                undo.push_back(CourseChange{CourseChange::Kind::Modify, ToCourse(*current)});
+                this->Update(std::move(change.course));
+                changedIds.push_back(courseId);
+            }
+        }
 
-        Course *c = node->ReturnCourse();
-        // Insert to left if course ID is less than current node's ID.
-        if (this->CompareNoCase(c->courseId, course.courseId) > 0)
+        // Re-validate only what the changes can have broken: the added and modified
+        // courses, and the courses that list a removed course as a prerequisite.
+        std::vector<std::string> affected;
+        if (applied)
         {
-            if (node->GetLeft() == nullptr)
+            affected = changedIds;
+            for (const std::string &courseId : removedIds)
             {
-                node->SetLeft(std::make_unique<Node>(course));
-                this->size++;
+                std::vector<std::string> listing = this->GetDependents(courseId);
+                affected.insert(affected.end(), listing.begin(), listing.end());
             }
-            else
+            std::sort(affected.begin(), affected.end(), [this](const std::string &first, const std::string &second)
+                      { return this->compare(first, second) < 0; });
+            affected.erase(std::unique(affected.begin(), affected.end(), [this](const std::string &first, const std::string &second)
+                                       { return this->compare(first, second) == 0; }),
+                           affected.end());
+        }
+        for (const std::string &courseId : affected)
+        {
+            CatalogCourse *course = this->Find(courseId);
+            if (course != nullptr && (!this->ValidateNameDescription(*course) || !this->CheckPrereqsOneCourse(*course)))
             {
-                AddNode(node->GetLeft(), course);
+                std::cout << "Bad Course: " << course->courseId->text << std::endl;
+                applied = false;
             }
         }
-        // Insert to right if course ID is greater than or equal to current node's ID.
-        else
+        if (applied)
+        {
+            return true;
+        }
+
+        // Roll back, newest change first.
+        for (size_t i = undo.size(); i-- > 0;)
         {
-            if (node->GetRight() == nullptr)
+            CourseChange &change = undo[i];
+            if (change.kind == CourseChange::Kind::Add)
             {
-                node->SetRight(std::make_unique<Node>(course));
-                this->size++;
+                this->Insert(std::move(change.course));
+            }
+            else if (change.kind == CourseChange::Kind::Remove)
+            {
+                this->Remove(change.course.courseId);
             }
             else
             {
-                AddNode(node->GetRight(), course);
+                this->Update(std::move(change.course));
             }
         }
+        return false;
     }
 
-    // Prints all courses in the tree in sorted order (in-order traversal).
-    void BinarySearchTree::PrintOrdered()
+    // Clears all courses from the tree, its indexes and its string pool.
+    void CourseTree::Clear()
     {
-        if (this->root != nullptr)
-        {
-            this->InOrder(this->root.get());
-        }
+        BinarySearchTree::Clear();
+        this->nameIndex.Clear();
+        this->suggestionIndex.Clear();
+        this->dependents.clear();
+        this->dependentsBuilt = false;
+        this->strings.Clear();
     }
 
-    // Recursively performs in-order traversal to print courses.
+    // Replaces the contents of the tree with already sorted, unique courses and
+    // rebuilds the indexes from them.
     // Parameters:
-    //   node - Pointer to the current node in the recursive traversal.
-    void BinarySearchTree::InOrder(Node *node)
+    //   courses - Ordered vector of unique courses.
+    void CourseTree::BuildFromSorted(std::vector<Course> courses)
     {
-        if (node->GetLeft() != nullptr)
+        this->Clear();
+        std::vector<CatalogCourse> stored;
+        stored.reserve(courses.size());
+        for (Course &course : courses)
         {
-            this->InOrder(node->GetLeft());
+            stored.push_back(this->ToCatalogCourse(course, std::move(course.courseName)));
+            std::copy(course.courseId.begin(), course.courseId.end(), stored.back().courseId->text.begin());
+            stored.back().courseId->inCatalog = true;
         }
-        this->PrintIdDescription(*node->ReturnCourse());
-        if (node->GetRight() != nullptr)
+        courses.clear();
+        BinarySearchTree::BuildFromSorted(std::move(stored));
+        this->ForEachInOrder([this](const CatalogCourse &course)
+                             {
+            this->nameIndex.Add(course.courseId->text, course.courseName);
+            this->suggestionIndex.Add(course.courseId->text); });
+    }
+
+    // Finds the courses whose names contain every word of a query, ignoring case.
+    // Parameters:
+    //   query - Words separated by spaces, e.g. "physics 2".
+    // Returns: Copies of the matching courses, sorted by course ID.
+    std::vector<Course> CourseTree::SearchNames(const std::string &query)
+    {
+        ScopedLatency timer(LatencyOperation::NameSearch);
+        std::vector<Course> courses;
+        for (const std::string &courseId : this->nameIndex.Search(query))
         {
-            this->InOrder(node->GetRight());
+            CatalogCourse *course = this->Find(courseId);
+            if (course != nullptr)
+            {
+                courses.push_back(ToCourse(*course));
+            }
         }
+        std::sort(courses.begin(), courses.end(), [this](const Course &first, const Course &second)
+                  { return this->compare(first.courseId, second.courseId) < 0; });
+        return courses;
     }
 
-    // Recursive function to traverse tree in order and build up a vector.
-    // Used by tree rebalancing function to get list of courses in order.
-    void BinarySearchTree::ListInOrder(Node *node, std::vector<Course> *courses)
+    // Prints the courses whose names contain every word of a query.
+    // Parameters:
+    //   query - Words separated by spaces.
+    void CourseTree::PrintNameSearch(std::string query)
     {
-        if (node->GetLeft() != nullptr)
+        std::vector<Course> courses = this->SearchNames(query);
+        if (courses.empty())
         {
-            this->ListInOrder(node->GetLeft(), courses);
+            std::cout << "No matching courses." << std::endl;
+            return;
         }
-        courses->push_back(*node->ReturnCourse());
-
-        if (node->GetRight() != nullptr)
+        for (const Course &course : courses)
         {
-            this->ListInOrder(node->GetRight(), courses);
+            PrintIdDescription(course);
         }
+        std::cout << "Matches: " << courses.size() << std::endl;
+    }
+
+    // Prints all courses in the tree in sorted order (in-order traversal).
+    void CourseTree::PrintOrdered()
+    {
+        ScopedLatency timer(LatencyOperation::PrintOrdered);
+        this->ForEachInOrder([](const CatalogCourse &course)
+                             { PrintIdDescription(course); });
     }
 
     // Prints details of a single course, including ID, name, and prerequisites.
     // Parameters:
     //   course - The Course object to print.
-    void BinarySearchTree::PrintCourse(Course course)
+    void CourseTree::PrintCourse(const Course &course)
     {
         std::cout << "------------------------------------------" << std::endl;
         std::cout << course.courseId << "    " << course.courseName << std::endl;
@@ -240,312 +361,233 @@ namespace BST
      // Prints details of a single course, including ID, name, and prerequisites.
     // Parameters:
     //   course - The Course object to print.
-    void BinarySearchTree::PrintIdDescription(Course course)
+    void CourseTree::PrintIdDescription(const Course &course)
     {
         std::cout << "------------------------------------------" << std::endl;
         std::cout << "Course: " << course.courseId << "   Description: " << course.courseName << std::endl;
         std::cout << "------------------------------------------" << std::endl;
     }
 
-    // Searches for a course by ID and stores it in the provided reference.
+    // Prints only the ID and name of a stored course.
     // Parameters:
-    //   id    - The course ID to search for.
-    //   empty - Reference to a Course object to store the found course.
-    void BinarySearchTree::FindCourse(std::string id, Course &empty)
+    //   course - The stored course to print.
+    void CourseTree::PrintIdDescription(const CatalogCourse &course)
     {
-        if (this->root != nullptr)
-        {
-            FindCourseRecursively(this->root.get(), id, empty);
-        }
+        std::cout << "------------------------------------------" << std::endl;
+        std::cout << "Course: " << course.courseId->text << "   Description: " << course.courseName << std::endl;
+        std::cout << "------------------------------------------" << std::endl;
     }
 
-    // Recursively searches for a course by ID.
+    // Prints "Course not found." and any suggested IDs for a failed lookup.
     // Parameters:
-    //   node  - Pointer to the current node in the recursive traversal.
-    //   id    - The course ID to search for.
-    //   empty - Reference to a Course object to store the found course.
-    void BinarySearchTree::FindCourseRecursively(Node *node, std::string id, Course &empty)
+    //   suggestions - IDs close to the one not found, closest first.
+    void CourseTree::PrintNotFound(const std::vector<std::string> &suggestions)
     {
-        if (CompareNoCase(node->ReturnCourse()->courseId, id) == 0)
-        {
-            empty = *node->ReturnCourse();
-        }
-        if (node->GetLeft() != nullptr)
+        std::cout << "Course not found." << std::endl;
+        for (size_t i = 0; i < suggestions.size(); i++)
         {
-            FindCourseRecursively(node->GetLeft(), id, empty);
+            std::cout << (i == 0 ? "Did you mean: " : ", ") << suggestions[i];
         }
-        if (node->GetRight() != nullptr)
+        if (!suggestions.empty())
         {
-            FindCourseRecursively(node->GetRight(), id, empty);
+            std::cout << "?" << std::endl;
         }
     }
 
     // Validates all courses in the tree, ensuring valid names and prerequisites.
+    // Parameters:
+    //   out - Stream the bad courses are reported to.
     // Returns: True if all courses are valid, false otherwise.
-    bool BinarySearchTree::ValidateCourses()
+    bool CourseTree::ValidateCourses(std::ostream &out)
     {
-        std::vector<std::tuple<std::string, std::string>> list;
-        this->GetListOfCourseNames(&list, this->root.get());
+        ScopedLatency timer(LatencyOperation::ValidateCourses);
+        BST_COUNT(validations, 1);
 
         bool isGood = true;
-        for (size_t i = 0; i < list.size(); i++)
-        {
-            auto [x, y] = list.at(i);
-            Course c;
-            c.courseId = x;
-            c.courseName = y;
-            isGood = ValidateNameDescription(c) && isGood;
-        }
-        this->CheckPrereqsRecursively(this->root.get(), &isGood, &list);
+        this->ForEachInOrder([this, &isGood](const CatalogCourse &course)
+                             { isGood = this->ValidateNameDescription(course) && isGood; });
+
+        // Report every course with a missing prerequisite, in order.
+        this->ForEachInOrder([this, &isGood, &out](const CatalogCourse &course)
+                             {
+            if (!course.prereqs.empty() && !this->CheckPrereqsOneCourse(course))
+            {
+                out << "Bad Course: " << course.courseId->text << std::endl;
+                isGood = false;
+            } });
         return isGood;
     }
 
-    // Recursively collects course IDs and names into a list.
+    // Prints details of a single course by ID.
     // Parameters:
-    //   list - Pointer to a vector of tuples containing course IDs and names.
-    //   node - Pointer to the current node in the recursive traversal.
-    void BinarySearchTree::GetListOfCourseNames(std::vector<std::tuple<std::string, std::string>> *list, Node *node)
+    //   id - The course ID to print.
+    void CourseTree::PrintSingleCourse(std::string id)
     {
-        if (node->GetLeft() != nullptr)
+        ScopedLatency timer(LatencyOperation::Lookup);
+        CatalogCourse *course = this->Find(id);
+        if (course != nullptr && !course->courseId->text.empty() && !course->courseName.empty())
         {
-            this->GetListOfCourseNames(list, node->GetLeft());
+            PrintCourse(ToCourse(*course));
         }
-        list->push_back(std::make_tuple(node->ReturnCourse()->courseId, node->ReturnCourse()->courseName));
-        if (node->GetRight() != nullptr)
+        else
         {
-            this->GetListOfCourseNames(list, node->GetRight());
+            PrintNotFound(this->SuggestIds(id));
         }
     }
 
-    // Recursively checks prerequisites for all courses.
+    // Returns the course IDs closest to one that was not found.
     // Parameters:
-    //   node - Pointer to the current node in the recursive traversal.
-    //   b    - Pointer to a boolean indicating if all prerequisites are valid.
-    //   list - Pointer to a vector of tuples containing course IDs and names.
-    void BinarySearchTree::CheckPrereqsRecursively(Node *node, bool *b, std::vector<std::tuple<std::string, std::string>> *list)
+    //   courseId - The mistyped course ID.
+    //   limit    - Most suggestions to return.
+    // Returns: Suggested IDs, closest first.
+    std::vector<std::string> CourseTree::SuggestIds(const std::string &courseId, size_t limit)
     {
-        if (node->GetLeft() != nullptr)
-        {
-            this->CheckPrereqsRecursively(node->GetLeft(), b, list);
-        }
-        std::vector<std::string> prereqs = node->ReturnCourse()->prereqs;
-        if (!prereqs.empty())
-        {
-            bool badCourse = this->CheckPrereqsOneCourse(*node->ReturnCourse(), *list);
-            if (!badCourse)
-            {
-                std::cout << "Bad Course: " << node->ReturnCourse()->courseId << std::endl;
-                *b = badCourse;
-            }
-        }
-        if (node->GetRight() != nullptr)
-        {
-            this->CheckPrereqsRecursively(node->GetRight(), b, list);
-        }
+        ScopedLatency timer(LatencyOperation::Suggest);
+        return this->suggestionIndex.Suggest(courseId, limit);
     }
 
-    // Prints details of a single course by ID.
-    // Parameters:
-    //   id - The course ID to print.
-    void BinarySearchTree::PrintSingleCourse(std::string id)
+    // Returns a copy of every course in the tree, sorted by course ID.
+    std::vector<Course> CourseTree::GetCoursesInOrder()
     {
-        Course course;
-        this->FindCourse(id, course);
-        if (!course.courseId.empty() && !course.courseName.empty())
-        {
-            this->PrintCourse(course);
-        }
-        else
-        {
-            std::cout << "Course not found." << std::endl;
-        }
+        std::vector<Course> courses;
+        courses.reserve(this->size);
+        this->ForEachInOrder([&courses](const CatalogCourse &course)
+                             { courses.push_back(ToCourse(course)); });
+        return courses;
     }
 
-    // Rebalances tree by calling private function ListInOrder with root.
-    // Once ordered vector is built, this clears BST and loads from middle.
-    void BinarySearchTree::RebalanceTree()
+    // Returns copies of a run of courses in ID order, starting from the first
+    // course's position without walking the courses before it.
+    // Parameters:
+    //   first - Zero-based position of the first course.
+    //   count - Most courses to return.
+    std::vector<Course> CourseTree::GetCoursesInRange(int first, int count)
     {
-        // Safety check.
-        if (this->root.get() == nullptr)
-        {
-            return;
-        }
-
-        // Built vector in sorted order.
         std::vector<Course> courses;
-        ListInOrder(this->root.get(), &courses);
-
-        if (courses.empty())
-        {
-            return;
-        }
-
-        this->Clear();
-
-        // Use for loops to reinsert.
-        this->root = std::move(BuildBalancedTree(courses, 0, courses.size()));
-        this->size = courses.size();
+        courses.reserve(std::max(0, std::min(count, this->size - first)));
+        this->ForEachInRange(first, count, [&courses](const CatalogCourse &course)
+                             { courses.push_back(ToCourse(course)); });
+        return courses;
     }
 
-    // Called Recursively to build tree balanced. Similar to
-    // Quicksort algorithm where it partitions vector into chunks until it reaches
-    // batches of 1.
-    // Parameters
-    //  courses - ordered vector of courses.
-    //  start  - low end of range to work on.
-    //  end  - high end of range to work on.
-    std::unique_ptr<Node> BinarySearchTree::BuildBalancedTree(const std::vector<Course> &courses, size_t start, size_t end)
+    // Prints the ID and name of the courses on one page of the ordered list,
+    // followed by the page number and the page count.
+    // Parameters:
+    //   page     - One-based page number.
+    //   pageSize - Courses per page.
+    void CourseTree::PrintPage(int page, int pageSize)
     {
-        if (start >= end || start >= courses.size())
+        ScopedLatency timer(LatencyOperation::Page);
+        int pageCount = pageSize > 0 ? (this->size + pageSize - 1) / pageSize : 0;
+        if (page < 1 || page > pageCount)
         {
-            return nullptr;
+            std::cout << "Page not found." << std::endl;
+            return;
         }
-
-        size_t mid = start + (end - start) / 2;
-        std::unique_ptr<Node> node = std::make_unique<Node>(courses[mid]);
-        node->SetLeft(BuildBalancedTree(courses, start, mid));
-        node->SetRight(BuildBalancedTree(courses, mid + 1, end));
-
-        return node;
+        this->ForEachInRange((page - 1) * pageSize, pageSize, [](const CatalogCourse &course)
+                             { PrintIdDescription(course); });
+        std::cout << "Page " << page << " of " << pageCount << std::endl;
     }
 
-    // Clears all nodes in the tree.
-    void BinarySearchTree::Clear()
+    // Validates the ID and name lengths of a course.
+    // Parameters:
+    //   course - The course to validate.
+    // Returns: True if the course ID and name have valid lengths, false otherwise.
+    bool CourseTree::ValidateNameDescription(const CatalogCourse &course)
     {
-        if (this->root == nullptr)
-        {
-            return; // Empty tree
-        }
-        if (this->root->GetLeft() != nullptr)
-        {
-            this->RecursiveClear(this->root->GetLeft());
-        }
-        if (this->root->GetRight() != nullptr)
-        {
-            this->RecursiveClear(this->root->GetRight());
-        }
-        this->root->ResetLeft();
-        this->root->ResetRight();
-        this->root = nullptr;
-        this->size = 0; // Reset size to 0.
+        return HasValidLengths(course.courseId->text, course.courseName);
     }
 
-    // Validates the name and description of a course.
+    // Checks the ID and name lengths every catalog requires of a course.
     // Parameters:
-    //   course - The Course object to validate.
-    // Returns: True if the course ID and name are valid and prerequisites exist, false otherwise.
-    bool BinarySearchTree::ValidateNameDescription(Course course)
+    //   courseId   - The course ID.
+    //   courseName - The course name.
+    // Returns: True if both lengths are valid, false otherwise.
+    bool CourseTree::HasValidLengths(std::string_view courseId, std::string_view courseName)
     {
         // Check course ID length (must be exactly 7 characters).
-        if (course.courseId.length() != 7)
+        if (courseId.length() != 7)
         {
             return false;
         }
         // Check course name length (must be between 3 and 40 characters).
-        if (course.courseName.length() < 3 || course.courseName.length() > 40)
+        if (courseName.length() < 3 || courseName.length() > 40)
         {
             return false;
         }
-        // If no prerequisites, course is valid.
-        if (course.prereqs.size() < 1)
+        return true;
+    }
+
+    // Adds the prerequisite references of a course to the dependents index.
+    // Parameters:
+    //   course - The course listing the prerequisites.
+    void CourseTree::AddDependents(const CatalogCourse &course)
+    {
+        for (StringHandle prereq : course.prereqs)
         {
-            return true;
+            this->dependents[prereq].push_back(course.courseId);
         }
-        // Check if all prerequisites exist in the tree.
-        std::vector<std::tuple<std::string, std::string>> names;
-        GetListOfCourseNames(&names, this->root.get());
-        return CheckPrereqsOneCourse(course, names);
     }
 
-    // Checks if a course's prerequisites exist in the tree.
+    // Removes the prerequisite references of a course from the dependents index.
     // Parameters:
-    //   course - Reference to the Course object to validate.
-    //   names  - Reference to a vector of tuples containing course IDs and names.
-    // Returns: True if all prerequisites exist, false otherwise.
-    bool BinarySearchTree::CheckPrereqsOneCourse(BST::Course &course, std::vector<std::tuple<std::string, std::string>> &names)
+    //   course - The course listing the prerequisites.
+    void CourseTree::RemoveDependents(const CatalogCourse &course)
     {
-        for (size_t j = 0; j < course.prereqs.size(); j++)
+        for (StringHandle prereq : course.prereqs)
         {
-            bool found = false;
-            for (size_t i = 0; i < names.size(); i++)
+            auto found = this->dependents.find(prereq);
+            if (found == this->dependents.end())
             {
-                auto [x, y] = names.at(i);
-                if (CompareNoCase(course.prereqs.at(j), x) == 0)
-                {
-                    found = true;
-                    break;
-                }
+                continue;
+            }
+            std::vector<StringHandle> &listing = found->second;
+            auto position = std::find(listing.begin(), listing.end(), course.courseId);
+            if (position != listing.end())
+            {
+                listing.erase(position);
             }
-            if (!found)
+            if (listing.empty())
             {
-                return false;
+                this->dependents.erase(found);
             }
         }
-        return true;
     }
 
-    // Checks if a course ID is unique in the tree.
+    // Returns the IDs of the courses listing a course as a prerequisite. The index
+    // is built from the whole tree on first use, then kept in step by every change.
     // Parameters:
-    //   course - The Course object to check.
-    // Returns: True if the course ID is unique, false if it already exists.
-    bool BinarySearchTree::IsCourseIdUnique(Course course)
+    //   courseId - The prerequisite course ID.
+    // Returns: IDs of the courses listing it.
+    std::vector<std::string> CourseTree::GetDependents(const std::string &courseId)
     {
-        if (this->root == nullptr)
+        if (!this->dependentsBuilt)
         {
-            return true; // Empty tree, ID is unique.
+            this->ForEachInOrder([this](const CatalogCourse &course)
+                                 { this->AddDependents(course); });
+            this->dependentsBuilt = true;
         }
-        std::vector<std::tuple<std::string, std::string>> list;
-        GetListOfCourseNames(&list, this->root.get());
-        if (list.size() < 1)
+        std::vector<std::string> courseIds;
+        auto found = this->dependents.find(this->strings.Find(courseId));
+        if (found != this->dependents.end())
         {
-            return true; // No courses, ID is unique.
-        }
-        for (size_t i = 0; i < list.size(); i++)
-        {
-            auto [x, y] = list.at(i);
-            if (CompareNoCase(x, course.courseId) == 0)
+            for (StringHandle dependent : found->second)
             {
-                return false; // ID already exists
+                courseIds.push_back(dependent->text);
             }
         }
-        return true;
+        return courseIds;
     }
 
-    // Recursively clears all nodes in the subtree rooted at the given node.
+    // Checks if a course's prerequisites exist in the tree. Each prerequisite is
+    // a handle that knows whether its course is loaded, so no search is needed.
     // Parameters:
-    //   node - Pointer to the current node in the recursive traversal.
-    void BinarySearchTree::RecursiveClear(Node *node)
+    //   course - Reference to the course to validate.
+    // Returns: True if all prerequisites exist, false otherwise.
+    bool CourseTree::CheckPrereqsOneCourse(const CatalogCourse &course)
     {
-        if (node->GetLeft() != nullptr)
-        {
-            this->RecursiveClear(node->GetLeft());
-        }
-        if (node->GetRight() != nullptr)
-        {
-            this->RecursiveClear(node->GetRight());
-        }
-        node->ResetLeft();
-        node->ResetRight();
-        this->size--;
-    }
-
-    // Recursively gets the height of the binary search tree. Used for rebalancing logic.
-    // Parameters:
-    //   node   - Pointer to the current node in the recursive traversal.
-    // Returns int (height of tree).
-    int BinarySearchTree::GetHeight(Node* node) {
-    if (!node) return 0;
-        return 1 + std::max(GetHeight(node->GetLeft()), GetHeight(node->GetRight()));
+        return std::all_of(course.prereqs.begin(), course.prereqs.end(), [](StringHandle prereq)
+                           { return prereq->inCatalog; });
     }
 
-    // Runs algorithm to decide whether a rebalancing is due. Checks the height of
-    // tree against the log of the size * 2.
-    // Returns bool (to rebalance if true).
-    bool BinarySearchTree::IsImbalanced() {
-        int height = GetHeight(root.get());
-        int n = this->size;
-        int logTimesTwo = (std::ceil(std::log2(n)) * 2);
-    return height > logTimesTwo;
-}
-
-} // namespace BST
\ No newline at end of file
+} // namespace BST
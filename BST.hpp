@@ -3,20 +3,118 @@
 // Author      : Shannon Musgrave
 // Version     : 1.0
 // Description : Header file defining the Binary Search Tree (BST) and related
-//               structures for the ABCU Course App. Contains declarations for
-//               Course structure, Node class, and BinarySearchTree class to manage
+//               structures for the ABCU Course App. Contains the generic
+//               BinarySearchTree template with its key and comparison policies,
+//               the Node template, and CourseTree, the instantiation that manages
 //               course data, including sorting and validating courses by prerequisites.
+//               CourseTree stores course IDs as handles into a string pool.
 //============================================================================
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
-#include <memory>
+#include "Latency.hpp"
+#include "NameIndex.hpp"
+#include "StringPool.hpp"
+#include "SuggestionIndex.hpp"
+
+// Build with -DABCU_STATS to compile in the tree's operation counters. Without it
+// BST_COUNT expands to nothing and the tree carries no counter state at all.
+#ifdef ABCU_STATS
+#define BST_COUNT(counter, amount) (this->stats.counter.fetch_add((amount), std::memory_order_relaxed))
+#else
+#define BST_COUNT(counter, amount) ((void)0)
+#endif
 
 namespace BST
 {
 
+    // Operation counters kept by a BinarySearchTree built with ABCU_STATS.
+    struct TreeStats
+    {
+        uint64_t comparisons = 0;        // Key comparisons.
+        uint64_t lookups = 0;            // Searches by key, including uniqueness checks.
+        uint64_t lookupNodesVisited = 0; // Nodes visited by all searches.
+        uint64_t rebalances = 0;         // Calls to RebalanceTree.
+        double rebalanceSeconds = 0;     // Time spent in RebalanceTree.
+        uint64_t nodeAllocations = 0;    // Nodes created.
+        uint64_t nodeFrees = 0;          // Nodes destroyed.
+        uint64_t validations = 0;        // Calls to ValidateCourses.
+        int height = 0;                  // Height of the tree when the stats were taken.
+    };
+
+#ifdef ABCU_STATS
+    // Live operation counters of a tree. Lookups may run on several threads at
+    // once under a shared lock (ShardedCatalog), so the counters they touch are
+    // relaxed atomics, as in LatencyHistogram. Rebalances only run under a
+    // writer's exclusive lock and are counted plainly.
+    struct TreeCounters
+    {
+        std::atomic<uint64_t> comparisons{0};        // Key comparisons.
+        std::atomic<uint64_t> lookups{0};            // Searches by key, including uniqueness checks.
+        std::atomic<uint64_t> lookupNodesVisited{0}; // Nodes visited by all searches.
+        uint64_t rebalances = 0;                     // Calls to RebalanceTree.
+        double rebalanceSeconds = 0;                 // Time spent in RebalanceTree.
+        std::atomic<uint64_t> nodeAllocations{0};    // Nodes created.
+        std::atomic<uint64_t> nodeFrees{0};          // Nodes destroyed.
+        std::atomic<uint64_t> validations{0};        // Calls to ValidateCourses.
+
+        // Returns the counts as a plain TreeStats, without the height.
+        TreeStats Load() const
+        {
+            TreeStats current;
+            current.comparisons = this->comparisons.load(std::memory_order_relaxed);
+            current.lookups = this->lookups.load(std::memory_order_relaxed);
+            current.lookupNodesVisited = this->lookupNodesVisited.load(std::memory_order_relaxed);
+            current.rebalances = this->rebalances;
+            current.rebalanceSeconds = this->rebalanceSeconds;
+            current.nodeAllocations = this->nodeAllocations.load(std::memory_order_relaxed);
+            current.nodeFrees = this->nodeFrees.load(std::memory_order_relaxed);
+            current.validations = this->validations.load(std::memory_order_relaxed);
+            return current;
+        }
+
+        // Sets every counter to a count of a TreeStats. The height is ignored.
+        void Store(const TreeStats &counts)
+        {
+            this->comparisons.store(counts.comparisons, std::memory_order_relaxed);
+            this->lookups.store(counts.lookups, std::memory_order_relaxed);
+            this->lookupNodesVisited.store(counts.lookupNodesVisited, std::memory_order_relaxed);
+            this->rebalances = counts.rebalances;
+            this->rebalanceSeconds = counts.rebalanceSeconds;
+            this->nodeAllocations.store(counts.nodeAllocations, std::memory_order_relaxed);
+            this->nodeFrees.store(counts.nodeFrees, std::memory_order_relaxed);
+            this->validations.store(counts.validations, std::memory_order_relaxed);
+        }
+
+        TreeCounters() = default;
+
+        // Copies keep the counts, so a tree moved into place keeps its counters.
+        TreeCounters(const TreeCounters &other)
+        {
+            this->Store(other.Load());
+        }
+
+        TreeCounters &operator=(const TreeCounters &other)
+        {
+            this->Store(other.Load());
+            return *this;
+        }
+    };
+#endif
+
     // Structure representing a course in the ABCU Course App.
     struct Course
     {
@@ -25,22 +123,112 @@ namespace BST
         std::vector<std::string> prereqs; // List of prerequisite course IDs.
     };
 
-    // Node class representing a node in the Binary Search Tree, holding a Course object.
+    // One line of a delta file: a course to add, remove or modify.
+    struct CourseChange
+    {
+        enum class Kind
+        {
+            Add,    // Insert a new course.
+            Remove, // Remove the course with this ID, only courseId is used.
+            Modify  // Replace the name and prerequisites of an existing course.
+        };
+        Kind kind;     // What to do with the course.
+        Course course; // The course to add or the new contents to modify it to.
+    };
+
+    // Key extraction policy for courses: a course is keyed by its ID.
+    struct CourseIdOf
+    {
+        const std::string &operator()(const Course &course) const
+        {
+            return course.courseId;
+        }
+    };
+
+    // A course as CourseTree stores it. The ID and every prerequisite are handles
+    // into the tree's string pool, so a prerequisite costs one pointer instead of
+    // a copy of the ID, and checking that it exists is a flag on its handle.
+    struct CatalogCourse
+    {
+        StringHandle courseId;             // Interned course ID.
+        std::string courseName;            // Name of the course.
+        std::vector<StringHandle> prereqs; // Interned prerequisite course IDs.
+    };
+
+    // Key extraction policy for stored courses: the text of the interned ID.
+    struct CatalogIdOf
+    {
+        std::string_view operator()(const CatalogCourse &course) const
+        {
+            return course.courseId->text;
+        }
+    };
+
+    // Three-way comparison policy. Returns <0 if first < second, 0 if equal and
+    // >0 if first > second, using the key type's own ordering.
+    template <typename Key, bool IgnoreCase = false>
+    struct KeyCompare
+    {
+        int operator()(const Key &first, const Key &second) const
+        {
+            return first < second ? -1 : (second < first ? 1 : 0);
+        }
+    };
+
+    // Case-insensitive ASCII specialization for string keys. Folds one character at a
+    // time while comparing, instead of copying and lowercasing both strings. Usable in
+    // constant expressions, so compiled-in catalogs can be checked at build time.
+    template <>
+    struct KeyCompare<std::string, true>
+    {
+        static constexpr unsigned char Fold(char c)
+        {
+            return static_cast<unsigned char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+        }
+
+        constexpr int operator()(std::string_view first, std::string_view second) const
+        {
+            size_t length = std::min(first.size(), second.size());
+            for (size_t i = 0; i < length; i++)
+            {
+                unsigned char a = Fold(first[i]);
+                unsigned char b = Fold(second[i]);
+                if (a != b)
+                {
+                    return a < b ? -1 : 1;
+                }
+            }
+            return first.size() < second.size() ? -1 : (first.size() > second.size() ? 1 : 0);
+        }
+    };
+
+    // Comparison used for course IDs.
+    using NoCaseCompare = KeyCompare<std::string, true>;
+
+    // Node class representing a node in the Binary Search Tree, holding one value.
+    template <typename Value>
     class Node
     {
     private:
         std::unique_ptr<Node> leftTree;  // Pointer to the left child node.
         std::unique_ptr<Node> rightTree; // Pointer to the right child node.
-        Course currentCourse;            // Course data stored in the node.
+        Value currentValue;              // Data stored in the node.
+        int height;                      // Height of the subtree rooted here, a leaf is 1.
+        int count;                       // Number of nodes in the subtree rooted here.
 
     public:
-        // Constructor: Initializes a node with a given course.
+        // Constructor: Initializes a node by constructing its value in place.
         // Parameters:
-        //   course - The Course object to store in the node.
-        Node(Course course);
+        //   args - Arguments forwarded to the value's constructor.
+        template <typename... Args>
+        explicit Node(std::in_place_t, Args &&...args);
 
-        // Returns a pointer to the course stored in the node.
-        Course *ReturnCourse();
+        // Destructor: Frees the subtree below this node iteratively, so deep
+        // trees cannot overflow the call stack.
+        ~Node();
+
+        // Returns a pointer to the value stored in the node.
+        Value *ReturnValue();
 
         // Gets the left child node.
         // Returns: Raw pointer to the left child node.
@@ -65,106 +253,194 @@ namespace BST
 
         // Resets the right child node to nullptr.
         void ResetRight();
+
+        // Removes the left child node and hands ownership to the caller.
+        std::unique_ptr<Node> TakeLeft();
+
+        // Removes the right child node and hands ownership to the caller.
+        std::unique_ptr<Node> TakeRight();
+
+        // Returns the height of the subtree rooted at this node.
+        int GetHeight();
+
+        // Returns the number of nodes in the subtree rooted at this node.
+        int GetCount();
+
+        // Recomputes the height and node count from those stored in the child nodes.
+        void UpdateSubtree();
+
+        // Returns the left subtree height minus the right subtree height.
+        int GetBalance();
     };
 
-    // Binary Search Tree class for managing courses, sorted by course ID and validated by prerequisites.
+    // Generic Binary Search Tree, kept height balanced with AVL rotations.
+    // Parameters:
+    //   Value   - Type stored in the tree.
+    //   KeyOf   - Policy returning the key of a value, e.g. CourseIdOf.
+    //   Compare - Three-way comparison policy for keys, e.g. NoCaseCompare.
+    // Both policies are plain types, so their calls are resolved and inlined at
+    // compile time. Keys are unique.
+    template <typename Value, typename KeyOf, typename Compare>
     class BinarySearchTree
     {
-    private:
-        int size;                   // Number of nodes in the tree.
-        std::unique_ptr<Node> root; // Root node of the tree.
+    public:
+        // Type of the key returned by KeyOf.
+        using Key = std::decay_t<decltype(std::declval<KeyOf>()(std::declval<const Value &>()))>;
+        using NodeType = Node<Value>;
+
+    protected:
+        // Deepest path AddNode can record. An AVL tree of height 64 would need more
+        // than 10^13 nodes, so the path fits in a fixed array and needs no allocation.
+        static constexpr int MAX_HEIGHT = 64;
+
+        int size;                       // Number of nodes in the tree.
+        std::unique_ptr<NodeType> root; // Root node of the tree.
+        KeyOf keyOf;                    // Key extraction policy.
+        Compare compare;                // Key comparison policy.
+#ifdef ABCU_STATS
+        TreeCounters stats; // Operation counters, only present in ABCU_STATS builds.
+#endif
 
-        // Recursively gets the height of the binary search tree. Used for rebalancing logic.
+        // Compares two keys with the comparison policy.
+        // Returns: Integer (<0 if first < second, 0 if equal, >0 if first > second).
+        int CompareKeys(const Key &first, const Key &second);
+
+        // Gets the height of the binary search tree from the height kept in each node.
+        // Used for rebalancing logic.
         // Parameters:
-        //   node   - Pointer to the current node in the recursive traversal.
+        //   node   - Root of the subtree to measure.
         //   Returns int (height of tree).
-        int GetHeight(Node* node);
+        int GetHeight(NodeType *node);
 
         // Runs algorithm to decide whether a rebalancing is due. Checks the height of
         // tree against the log of the size * 2.
         //   Returns bool (to rebalance if true).
         bool IsImbalanced();
 
+        // Iteratively adds a node for a key to the tree and rebalances the path back
+        // to the root with AVL rotations. The node is only created once the key is
+        // known to be unique.
+        // Parameters:
+        //   key  - Key of the new value.
+        //   make - Function returning the new node, called at most once.
+        //   Returns: True if the node was added, false if the key already exists.
+        template <typename Make>
+        bool AddNode(const Key &key, Make make);
+
+        // Rotates a subtree left, returning its new root.
+        static std::unique_ptr<NodeType> RotateLeft(std::unique_ptr<NodeType> node);
+
+        // Rotates a subtree right, returning its new root.
+        static std::unique_ptr<NodeType> RotateRight(std::unique_ptr<NodeType> node);
 
-        // Recursively adds a node with the given course to the tree.
+        // Restores the balance of a subtree with a single or double rotation.
         // Parameters:
-        //   node   - Pointer to the current node in the recursive traversal.
-        //   course - The Course object to insert.
-        void AddNode(Node *node, Course course);
+        //   node - The subtree whose children differ in height by two.
+        //   Returns: The new subtree root.
+        static std::unique_ptr<NodeType> Rebalance(std::unique_ptr<NodeType> node);
 
-        // Performs case-insensitive string comparison.
+        // Searches for the node holding a key by walking down from the root.
         // Parameters:
-        //   first  - First string to compare.
-        //   second - Second string to compare.
-        //   Returns: Integer indicating comparison result (<0 if first < second, 0 if equal, >0 if first > second).
-        int CompareNoCase(std::string first, std::string second);
+        //   key - The key to search for.
+        //   Returns: The node holding the key, or nullptr if there is none.
+        NodeType *FindNode(const Key &key);
 
-        // Recursively prints courses in-order (sorted by course ID).
+        // Visits every node of a subtree in order using an explicit stack.
         // Parameters:
-        //   node - Pointer to the current node in the recursive traversal.
-        void InOrder(Node *node);
+        //   node  - Root of the subtree to visit, may be nullptr.
+        //   visit - Function called with each node, smallest key first.
+        template <typename Visit>
+        void VisitInOrder(NodeType *node, Visit visit);
 
-        void ListInOrder(Node *node, std::vector<Course> *courses);
+        // Recursive helper method for RebalanceTree is called to build up after old tree is cleared.
+        // The values are moved into the new nodes.
+        std::unique_ptr<NodeType> BuildBalancedTree(std::vector<Value> &values, size_t start, size_t end);
 
-        // Prints details of a single course including prerequisites.
+    public:
+        // Constructor: Initializes an empty Binary Search Tree.
+        BinarySearchTree();
+
+        // Returns the number of values in the tree.
+        int GetSize();
+
+        // Inserts a copy of a value into the tree. The copy is made directly in the
+        // new node and only when the key is unique.
         // Parameters:
-        //   course - The Course object to print.
-        void PrintCourse(Course course);
+        //   value - The value to insert.
+        //   Returns: True if insertion is successful, false if the key already exists.
+        bool Insert(const Value &value);
 
-        // Prints only name and description of course.
+        // Moves a value into the tree. The value is moved directly into the new
+        // node and is left untouched if the key already exists.
         // Parameters:
-        //   course - The Course object to print.
-        void PrintIdDescription(Course course);
+        //   value - The value to insert.
+        //   Returns: True if insertion is successful, false if the key already exists.
+        bool Insert(Value &&value);
 
-        // Searches for a course by ID and stores it in the provided reference.
+        // Constructs a value in place in a new node and links it into the tree.
         // Parameters:
-        //   id    - The course ID to search for.
-        //   empty - Reference to a Course object to store the found course.
-        void FindCourse(std::string id, Course &empty);
+        //   args - Arguments forwarded to the value's constructor.
+        //   Returns: True if insertion is successful, false if the key already exists,
+        //            in which case the constructed value is discarded.
+        template <typename... Args>
+        bool Emplace(Args &&...args);
 
-        // Recursively searches for a course by ID and stores it in the provided reference.
+        // Searches for a value by key.
         // Parameters:
-        //   node  - Pointer to the current node in the recursive traversal.
-        //   id    - The course ID to search for.
-        //   empty - Reference to a Course object to store the found course.
-        void FindCourseRecursively(Node *node, std::string courseId, Course &empty);
+        //   key - The key to search for.
+        //   Returns: Pointer to the value in the tree, or nullptr if there is none.
+        Value *Find(const Key &key);
 
-        // Recursively collects course IDs and names into a list.
+        // Removes the value with a key and rebalances the path back to the root.
         // Parameters:
-        //   list - Pointer to a vector of tuples containing course IDs and names.
-        //   node - Pointer to the current node in the recursive traversal.
-        void GetListOfCourseNames(std::vector<std::tuple<std::string, std::string>> *list, Node *node);
+        //   key     - The key to remove.
+        //   removed - If not nullptr, receives the removed value.
+        //   Returns: True if a value was removed, false if the key does not exist.
+        bool Remove(const Key &key, Value *removed = nullptr);
 
-        // Recursively checks prerequisites for all courses.
+        // Replaces the value with the same key. The tree shape is not touched.
         // Parameters:
-        //   node - Pointer to the current node in the recursive traversal.
-        //   isGood - Pointer to a boolean indicating if all prerequisites are valid.
-        //   list - Pointer to a vector of tuples containing course IDs and names.
-        void CheckPrereqsRecursively(Node *node, bool *isGood, std::vector<std::tuple<std::string, std::string>> *list);
+        //   value - The new value.
+        //   Returns: True if a value was replaced, false if the key does not exist.
+        bool Update(Value value);
 
-        // Validates the name and description of a course.
+        // Calls a function with every value in key order.
         // Parameters:
-        //   course - The Course object to validate.
-        //   Returns: True if the course name and description are valid, false otherwise.
-        bool ValidateNameDescription(Course course);
+        //   visit - Function taking a const reference to a value.
+        template <typename Visit>
+        void ForEachInOrder(Visit visit);
 
-        // Checks if a course's prerequisites exist in the tree.
+        // Counts the values with a key less than a key, using the subtree counts
+        // kept in each node, so it only walks one path.
         // Parameters:
-        //   course - Reference to the Course object to validate.
-        //   names  - Reference to a vector of tuples containing course IDs and names.
-        //   Returns: True if all prerequisites exist, false otherwise.
-        bool CheckPrereqsOneCourse(BST::Course &course, std::vector<std::tuple<std::string, std::string>> &list);
+        //   key - The key to rank, need not be in the tree.
+        //   Returns: Number of smaller keys, which is the key's position in key
+        //            order when it is present.
+        int Rank(const Key &key);
 
-        // Checks if a course ID is unique in the tree.
+        // Finds the value at a position in key order, using the subtree counts
+        // kept in each node, so it only walks one path.
         // Parameters:
-        //   course - The Course object to check.
-        //   Returns: True if the course ID is unique, false if it already exists.
-        bool IsCourseIdUnique(Course course);
+        //   position - Zero-based position, the smallest key is 0.
+        //   Returns: Pointer to the value, or nullptr if position is out of range.
+        Value *Select(int position);
 
-        // Recursively clears all nodes in the tree.
+        // Calls a function with a run of values in key order. The first value is
+        // found in one walk down the tree and the rest are streamed from there,
+        // so a page deep in the tree costs no more than the first page.
         // Parameters:
-        //   node - Pointer to the current node in the recursive traversal.
-        void RecursiveClear(Node *node);
+        //   first - Zero-based position of the first value.
+        //   count - Most values to visit.
+        //   visit - Function taking a const reference to a value.
+        //   Returns: Number of values visited.
+        template <typename Visit>
+        int ForEachInRange(int first, int count, Visit visit);
+
+        // Returns a copy of every value in the tree, in key order.
+        std::vector<Value> GetInOrder();
+
+        // Clears all values from the tree.
+        void Clear();
 
         // Rebalances tree by copying to a vector and then clearing tree. So that
         // it can be rebuilt from scratch.
@@ -172,36 +448,1053 @@ namespace BST
         //   Returns: void
         void RebalanceTree();
 
-        // Recursive helper method for RebalanceTree is called to build up after old tree is cleared.
-        std::unique_ptr<Node> BuildBalancedTree(const std::vector<Course> &courses, size_t start, size_t end);
+        // Replaces the contents of the tree with values that are already sorted by
+        // key and free of duplicates, building the tree balanced in one pass.
+        // Parameters:
+        //   values - Ordered vector of unique values, pass with std::move to avoid a copy.
+        void BuildFromSorted(std::vector<Value> values);
+
+        // Returns the operation counters and the current height. All counters are
+        // zero unless the program was built with ABCU_STATS.
+        TreeStats GetStats();
+
+        // Resets the operation counters to zero.
+        void ResetStats();
+
+        // Prints the operation counters as a small report.
+        void PrintStats();
+    };
+
+    // Binary Search Tree of courses, sorted by case-insensitive course ID and
+    // validated by prerequisites. Courses go in and come out as Course; inside
+    // the tree they are kept as CatalogCourse, with every ID interned once.
+    class CourseTree : public BinarySearchTree<CatalogCourse, CatalogIdOf, NoCaseCompare>
+    {
+    private:
+        StringPool strings;              // Every course and prerequisite ID, cleared with the tree.
+        NameIndex nameIndex;             // Trigram index of the course names, kept in step with the tree.
+        SuggestionIndex suggestionIndex; // Course IDs for "did you mean" suggestions, kept in step with the tree.
+
+        // Courses listing each prerequisite, keyed by the prerequisite's handle.
+        // Only needed to re-validate after a removal, so it is built on first use
+        // and then kept in step with the tree.
+        std::unordered_map<StringHandle, std::vector<StringHandle>> dependents;
+        bool dependentsBuilt = false; // True once dependents covers every course.
+
+        // Interns the ID and prerequisites of a course.
+        // Parameters:
+        //   course - The course to convert.
+        //   name   - The course name, copied or moved from the course by the caller.
+        //   Returns: The course as the tree stores it.
+        CatalogCourse ToCatalogCourse(const Course &course, std::string name);
+
+        // Copies a stored course back out as a Course.
+        static Course ToCourse(const CatalogCourse &course);
+
+        // Inserts a course copied or moved from a Course, shared by both Insert overloads.
+        template <typename CourseRef>
+        bool InsertCourse(CourseRef &&course);
+
+        // Adds or removes the prerequisite references of a course in dependents.
+        void AddDependents(const CatalogCourse &course);
+        void RemoveDependents(const CatalogCourse &course);
+
+        // Returns the IDs of the courses listing a course as a prerequisite,
+        // building the dependents index first if needed.
+        // Parameters:
+        //   courseId - The prerequisite course ID.
+        std::vector<std::string> GetDependents(const std::string &courseId);
+
+        // Validates the ID and name lengths of a course.
+        // Parameters:
+        //   course - The course to validate.
+        //   Returns: True if the course ID and name have valid lengths, false otherwise.
+        bool ValidateNameDescription(const CatalogCourse &course);
+
+        // Checks if a course's prerequisites exist in the tree.
+        // Parameters:
+        //   course - Reference to the course to validate.
+        //   Returns: True if all prerequisites exist, false otherwise.
+        bool CheckPrereqsOneCourse(const CatalogCourse &course);
 
     public:
-        // Constructor: Initializes an empty Binary Search Tree.
-        BinarySearchTree();
+        // Prints details of a single course including prerequisites.
+        // Parameters:
+        //   course - The Course object to print.
+        static void PrintCourse(const Course &course);
 
-        // Returns the number of courses in the tree.
-        int GetSize();
+        // Prints only name and description of course.
+        // Parameters:
+        //   course - The Course object to print.
+        static void PrintIdDescription(const Course &course);
+        static void PrintIdDescription(const CatalogCourse &course);
+
+        // Prints the answer to a failed lookup: "Course not found." and then
+        // "Did you mean: ...?" with any suggested IDs.
+        // Parameters:
+        //   suggestions - IDs close to the one not found, closest first.
+        static void PrintNotFound(const std::vector<std::string> &suggestions);
 
-        // Inserts a new course into the tree.
+        // Checks the ID and name lengths every catalog requires of a course.
+        // Parameters:
+        //   courseId   - The course ID, exactly 7 characters.
+        //   courseName - The course name, 3 to 40 characters.
+        //   Returns: True if both lengths are valid.
+        static bool HasValidLengths(std::string_view courseId, std::string_view courseName);
+
+        // Inserts a copy of a course into the tree.
         // Parameters:
         //   course - The Course object to insert.
         //   Returns: True if insertion is successful, false otherwise.
-        bool Insert(Course course);
+        bool Insert(const Course &course);
+
+        // Moves a course into the tree. The course is left untouched if its ID
+        // already exists, so the caller can still report it.
+        // Parameters:
+        //   course - The Course object to insert.
+        //   Returns: True if insertion is successful, false otherwise.
+        bool Insert(Course &&course);
+
+        // Constructs a course from the given arguments and moves it into the tree.
+        // Parameters:
+        //   args - Arguments forwarded to the Course constructor.
+        //   Returns: True if insertion is successful, false otherwise.
+        template <typename... Args>
+        bool Emplace(Args &&...args)
+        {
+            return this->Insert(Course(std::forward<Args>(args)...));
+        }
+
+        // Removes a course and its index entries.
+        // Parameters:
+        //   courseId - ID of the course to remove.
+        //   removed  - If not nullptr, receives the removed course.
+        //   Returns: True if the course was removed, false if it does not exist.
+        bool Remove(const std::string &courseId, Course *removed = nullptr);
+
+        // Replaces the name and prerequisites of a course. The stored ID keeps its
+        // original spelling.
+        // Parameters:
+        //   course - The new contents, found by course ID.
+        //   Returns: True if the course was updated, false if it does not exist.
+        bool Update(Course course);
+
+        // Applies a list of changes as one unit. Only the changed courses and the
+        // courses listing a removed course as a prerequisite are re-validated. If
+        // any change cannot be applied or validation fails, every change already
+        // made is undone and the tree is left as it was.
+        // Parameters:
+        //   changes - The changes in the order to apply them.
+        //   Returns: True if every change was applied and the result is valid.
+        bool ApplyChanges(std::vector<CourseChange> changes);
+
+        // Clears all courses from the tree and its indexes.
+        void Clear();
+
+        // Replaces the contents of the tree with courses that are already sorted by
+        // ID and free of duplicates, and rebuilds the indexes.
+        // Parameters:
+        //   courses - Ordered vector of unique courses.
+        void BuildFromSorted(std::vector<Course> courses);
+
+        // Finds the courses whose names contain every word of a query, ignoring case.
+        // Parameters:
+        //   query - Words separated by spaces, e.g. "physics 2".
+        //   Returns: Copies of the matching courses, sorted by course ID.
+        std::vector<Course> SearchNames(const std::string &query);
+
+        // Prints the courses whose names contain every word of a query.
+        // Parameters:
+        //   query - Words separated by spaces.
+        void PrintNameSearch(std::string query);
 
         // Prints all courses in the tree in sorted order.
-        void PrintOrdered();        
+        void PrintOrdered();
 
         // Validates all courses in the tree, ensuring valid prerequisites.
-        // Returns: True if all courses are valid, false otherwise.
-        bool ValidateCourses();
+        // Parameters:
+        //   out - Stream the bad courses are reported to, the console by default.
+        //   Returns: True if all courses are valid, false otherwise.
+        bool ValidateCourses(std::ostream &out = std::cout);
 
-        // Prints details of a single course by ID.
+        // Prints details of a single course by ID, or the closest IDs if it is not found.
         // Parameters:
         //   id - The course ID to print.
         void PrintSingleCourse(std::string courseId);
 
-        // Clears all courses from the tree.
-        void Clear();
+        // Returns the course IDs closest to one that was not found: those one edit
+        // away if there are any, otherwise those two edits away.
+        // Parameters:
+        //   courseId - The mistyped course ID.
+        //   limit    - Most suggestions to return.
+        //   Returns: Suggested IDs, closest first.
+        std::vector<std::string> SuggestIds(const std::string &courseId, size_t limit = 5);
+
+        // Returns a copy of every course in the tree, sorted by course ID.
+        std::vector<Course> GetCoursesInOrder();
+
+        // Returns copies of a run of courses in ID order, without walking the
+        // courses before it.
+        // Parameters:
+        //   first - Zero-based position of the first course.
+        //   count - Most courses to return.
+        std::vector<Course> GetCoursesInRange(int first, int count);
+
+        // Prints the ID and name of the courses on one page of the ordered list.
+        // Parameters:
+        //   page     - One-based page number.
+        //   pageSize - Courses per page.
+        void PrintPage(int page, int pageSize);
     };
 
+    // Node template implementation.
+
+    // Constructor: Initializes a node by constructing its value in place, so a
+    // value handed to the tree is copied or moved only once, into its node.
+    // Parameters:
+    //   args - Arguments forwarded to the value's constructor.
+    template <typename Value>
+    template <typename... Args>
+    Node<Value>::Node(std::in_place_t, Args &&...args) : currentValue(std::forward<Args>(args)...), height(1), count(1)
+    {
+        // left and right are automatically initialized to nullptr by unique_ptr.
+    }
+
+    // Destructor: Frees the subtree below this node without recursion or allocation.
+    // Left children are rotated up until the node in hand has none, then it is
+    // freed and its right child taken in its place, so a long chain of nodes cannot
+    // overflow the call stack and a failed allocation cannot terminate the program.
+    template <typename Value>
+    Node<Value>::~Node()
+    {
+        std::unique_ptr<Node> rest = std::move(this->leftTree);
+        while (rest != nullptr || this->rightTree != nullptr)
+        {
+            if (rest == nullptr)
+            {
+                rest = std::move(this->rightTree);
+            }
+            else if (rest->leftTree != nullptr)
+            {
+                // Rotate right: the left child becomes the node in hand.
+                std::unique_ptr<Node> left = std::move(rest->leftTree);
+                rest->leftTree = std::move(left->rightTree);
+                left->rightTree = std::move(rest);
+                rest = std::move(left);
+            }
+            else
+            {
+                // No left child: free the node, its destructor has nothing left to free.
+                rest = std::move(rest->rightTree);
+            }
+        }
+    }
+
+    // Returns a raw pointer to the left child node.
+    // Returns: Raw pointer to the left child node, or nullptr if none exists.
+    template <typename Value>
+    Node<Value> *Node<Value>::GetLeft()
+    {
+        return this->leftTree.get();
+    }
+
+    // Returns a raw pointer to the right child node.
+    // Returns: Raw pointer to the right child node, or nullptr if none exists.
+    template <typename Value>
+    Node<Value> *Node<Value>::GetRight()
+    {
+        return this->rightTree.get();
+    }
+
+    // Sets the left child node.
+    // Parameters:
+    //   node - Unique pointer to the new left child node.
+    template <typename Value>
+    void Node<Value>::SetLeft(std::unique_ptr<Node> node)
+    {
+        this->leftTree = std::move(node);
+    }
+
+    // Sets the right child node.
+    // Parameters:
+    //   node - Unique pointer to the new right child node.
+    template <typename Value>
+    void Node<Value>::SetRight(std::unique_ptr<Node> node)
+    {
+        this->rightTree = std::move(node);
+    }
+
+    // Resets the left child node to nullptr.
+    template <typename Value>
+    void Node<Value>::ResetLeft()
+    {
+        this->leftTree.reset();
+    }
+
+    // Resets the right child node to nullptr.
+    template <typename Value>
+    void Node<Value>::ResetRight()
+    {
+        this->rightTree.reset();
+    }
+
+    // Removes the left child node and hands ownership to the caller.
+    // Returns: Unique pointer to the former left child node.
+    template <typename Value>
+    std::unique_ptr<Node<Value>> Node<Value>::TakeLeft()
+    {
+        return std::move(this->leftTree);
+    }
+
+    // Removes the right child node and hands ownership to the caller.
+    // Returns: Unique pointer to the former right child node.
+    template <typename Value>
+    std::unique_ptr<Node<Value>> Node<Value>::TakeRight()
+    {
+        return std::move(this->rightTree);
+    }
+
+    // Returns a pointer to the value stored in the node.
+    template <typename Value>
+    Value *Node<Value>::ReturnValue()
+    {
+        return &this->currentValue;
+    }
+
+    // Returns the height of the subtree rooted at this node (a leaf is 1).
+    template <typename Value>
+    int Node<Value>::GetHeight()
+    {
+        return this->height;
+    }
+
+    // Returns the number of nodes in the subtree rooted at this node (a leaf is 1).
+    template <typename Value>
+    int Node<Value>::GetCount()
+    {
+        return this->count;
+    }
+
+    // Recomputes the height and node count from those stored in the child nodes.
+    template <typename Value>
+    void Node<Value>::UpdateSubtree()
+    {
+        int left = this->leftTree ? this->leftTree->height : 0;
+        int right = this->rightTree ? this->rightTree->height : 0;
+        this->height = 1 + std::max(left, right);
+        int leftCount = this->leftTree ? this->leftTree->count : 0;
+        int rightCount = this->rightTree ? this->rightTree->count : 0;
+        this->count = 1 + leftCount + rightCount;
+    }
+
+    // Returns the left subtree height minus the right subtree height.
+    template <typename Value>
+    int Node<Value>::GetBalance()
+    {
+        int left = this->leftTree ? this->leftTree->height : 0;
+        int right = this->rightTree ? this->rightTree->height : 0;
+        return left - right;
+    }
+
+    // BinarySearchTree template implementation.
+
+    // Constructor: Initializes an empty Binary Search Tree.
+    template <typename Value, typename KeyOf, typename Compare>
+    BinarySearchTree<Value, KeyOf, Compare>::BinarySearchTree()
+    {
+        this->size = 0; // Initialize size to 0.
+    }
+
+    // Returns the number of values in the tree.
+    // Returns: The size of the tree.
+    template <typename Value, typename KeyOf, typename Compare>
+    int BinarySearchTree<Value, KeyOf, Compare>::GetSize()
+    {
+        return this->size;
+    }
+
+    // Compares two keys with the comparison policy.
+    // Parameters:
+    //   first  - First key to compare.
+    //   second - Second key to compare.
+    // Returns: Integer (<0 if first < second, 0 if equal, >0 if first > second).
+    template <typename Value, typename KeyOf, typename Compare>
+    int BinarySearchTree<Value, KeyOf, Compare>::CompareKeys(const Key &first, const Key &second)
+    {
+        BST_COUNT(comparisons, 1);
+        return this->compare(first, second);
+    }
+
+    // Inserts a copy of a value into the tree if its key is unique.
+    // Parameters:
+    //   value - The value to insert.
+    // Returns: True if insertion is successful, false if the key already exists.
+    template <typename Value, typename KeyOf, typename Compare>
+    bool BinarySearchTree<Value, KeyOf, Compare>::Insert(const Value &value)
+    {
+        return this->AddNode(this->keyOf(value), [&value]()
+                             { return std::make_unique<NodeType>(std::in_place, value); });
+    }
+
+    // Moves a value into the tree if its key is unique.
+    // Parameters:
+    //   value - The value to insert, left untouched if the key already exists.
+    // Returns: True if insertion is successful, false if the key already exists.
+    template <typename Value, typename KeyOf, typename Compare>
+    bool BinarySearchTree<Value, KeyOf, Compare>::Insert(Value &&value)
+    {
+        return this->AddNode(this->keyOf(value), [&value]()
+                             { return std::make_unique<NodeType>(std::in_place, std::move(value)); });
+    }
+
+    // Constructs a value in place in a new node and links it into the tree if its
+    // key is unique. The key is only known once the value exists, so the node is
+    // built first and dropped again on a duplicate.
+    // Parameters:
+    //   args - Arguments forwarded to the value's constructor.
+    // Returns: True if insertion is successful, false if the key already exists.
+    template <typename Value, typename KeyOf, typename Compare>
+    template <typename... Args>
+    bool BinarySearchTree<Value, KeyOf, Compare>::Emplace(Args &&...args)
+    {
+        std::unique_ptr<NodeType> node = std::make_unique<NodeType>(std::in_place, std::forward<Args>(args)...);
+        return this->AddNode(this->keyOf(*node->ReturnValue()), [&node]()
+                             { return std::move(node); });
+    }
+
+    // Adds a node for a key to the tree. Walks down iteratively while remembering
+    // the path and stops if the key is already present. Otherwise the node is made
+    // and linked in, then the path is walked back up updating heights and subtree
+    // counts and rotating any node whose subtrees differ in height by more than one
+    // (AVL balancing).
+    // Parameters:
+    //   key  - Key of the new value.
+    //   make - Function returning the new node, called at most once.
+    // Returns: True if the node was added, false if the key already exists.
+    template <typename Value, typename KeyOf, typename Compare>
+    template <typename Make>
+    bool BinarySearchTree<Value, KeyOf, Compare>::AddNode(const Key &key, Make make)
+    {
+        NodeType *path[MAX_HEIGHT]; // Nodes from the root down to the new node's parent.
+        bool wentLeft[MAX_HEIGHT];  // Direction taken below each node on the path.
+        size_t depth = 0;
+        BST_COUNT(lookups, 1);
+        NodeType *node = this->root.get();
+        while (node != nullptr)
+        {
+            BST_COUNT(lookupNodesVisited, 1);
+            int result = this->CompareKeys(this->keyOf(*node->ReturnValue()), key);
+            if (result == 0)
+            {
+                return false; // Key already exists.
+            }
+            path[depth] = node;
+            // Insert to left if the key is less than current node's key.
+            wentLeft[depth] = result > 0;
+            node = wentLeft[depth] ? node->GetLeft() : node->GetRight();
+            depth++;
+        }
+
+        std::unique_ptr<NodeType> leaf = make();
+        BST_COUNT(nodeAllocations, 1);
+        this->size++;
+        if (depth == 0)
+        {
+            this->root = std::move(leaf);
+            return true;
+        }
+        if (wentLeft[depth - 1])
+        {
+            path[depth - 1]->SetLeft(std::move(leaf));
+        }
+        else
+        {
+            path[depth - 1]->SetRight(std::move(leaf));
+        }
+
+        // Walk back up, fixing heights and counts and rotating where the balance broke.
+        // Once the balance is settled, the nodes above only need their counts fixed.
+        bool settled = false;
+        for (size_t i = depth; i-- > 0;)
+        {
+            NodeType *current = path[i];
+            int oldHeight = current->GetHeight();
+            current->UpdateSubtree();
+            if (settled)
+            {
+                continue;
+            }
+            int balance = current->GetBalance();
+            if (balance > 1 || balance < -1)
+            {
+                // Detach the subtree from its parent, rotate it and reattach it.
+                if (i == 0)
+                {
+                    this->root = Rebalance(std::move(this->root));
+                }
+                else if (wentLeft[i - 1])
+                {
+                    path[i - 1]->SetLeft(Rebalance(path[i - 1]->TakeLeft()));
+                }
+                else
+                {
+                    path[i - 1]->SetRight(Rebalance(path[i - 1]->TakeRight()));
+                }
+                settled = true; // A rotation after an insert restores the old subtree height.
+            }
+            else if (current->GetHeight() == oldHeight)
+            {
+                settled = true; // Height unchanged, so no balance above can have changed either.
+            }
+        }
+
+        // Rebalancing logic
+        // Tree of sufficient size, once in 100 insertions, and is imbalanced.
+        // AddNode keeps the tree height balanced, so this is only a safety net.
+        bool isModded = this->size % 100 == 0;
+        if (this->size > 500 && isModded && IsImbalanced())
+        {
+            this->RebalanceTree();
+        }
+        return true;
+    }
+
+    // Rotates a subtree left, making its right child the new subtree root.
+    // Parameters:
+    //   node - The subtree to rotate.
+    // Returns: The new subtree root.
+    template <typename Value, typename KeyOf, typename Compare>
+    std::unique_ptr<Node<Value>> BinarySearchTree<Value, KeyOf, Compare>::RotateLeft(std::unique_ptr<NodeType> node)
+    {
+        std::unique_ptr<NodeType> pivot = node->TakeRight();
+        node->SetRight(pivot->TakeLeft());
+        node->UpdateSubtree();
+        pivot->SetLeft(std::move(node));
+        pivot->UpdateSubtree();
+        return pivot;
+    }
+
+    // Rotates a subtree right, making its left child the new subtree root.
+    // Parameters:
+    //   node - The subtree to rotate.
+    // Returns: The new subtree root.
+    template <typename Value, typename KeyOf, typename Compare>
+    std::unique_ptr<Node<Value>> BinarySearchTree<Value, KeyOf, Compare>::RotateRight(std::unique_ptr<NodeType> node)
+    {
+        std::unique_ptr<NodeType> pivot = node->TakeLeft();
+        node->SetLeft(pivot->TakeRight());
+        node->UpdateSubtree();
+        pivot->SetRight(std::move(node));
+        pivot->UpdateSubtree();
+        return pivot;
+    }
+
+    // Restores the balance of a subtree whose children differ in height by two,
+    // using a single or double rotation.
+    // Parameters:
+    //   node - The unbalanced subtree.
+    // Returns: The new subtree root.
+    template <typename Value, typename KeyOf, typename Compare>
+    std::unique_ptr<Node<Value>> BinarySearchTree<Value, KeyOf, Compare>::Rebalance(std::unique_ptr<NodeType> node)
+    {
+        int balance = node->GetBalance();
+        if (balance > 1)
+        {
+            if (node->GetLeft()->GetBalance() < 0)
+            {
+                node->SetLeft(RotateLeft(node->TakeLeft()));
+            }
+            return RotateRight(std::move(node));
+        }
+        if (balance < -1)
+        {
+            if (node->GetRight()->GetBalance() > 0)
+            {
+                node->SetRight(RotateRight(node->TakeRight()));
+            }
+            return RotateLeft(std::move(node));
+        }
+        return node;
+    }
+
+    // Searches for the node holding a key by walking down from the root.
+    // Parameters:
+    //   key - The key to search for.
+    // Returns: The node holding the key, or nullptr if there is none.
+    template <typename Value, typename KeyOf, typename Compare>
+    Node<Value> *BinarySearchTree<Value, KeyOf, Compare>::FindNode(const Key &key)
+    {
+        BST_COUNT(lookups, 1);
+        NodeType *node = this->root.get();
+        while (node != nullptr)
+        {
+            BST_COUNT(lookupNodesVisited, 1);
+            int result = this->CompareKeys(this->keyOf(*node->ReturnValue()), key);
+            if (result == 0)
+            {
+                return node;
+            }
+            node = result > 0 ? node->GetLeft() : node->GetRight();
+        }
+        return nullptr;
+    }
+
+    // Searches for a value by key.
+    // Parameters:
+    //   key - The key to search for.
+    // Returns: Pointer to the value in the tree, or nullptr if there is none.
+    template <typename Value, typename KeyOf, typename Compare>
+    Value *BinarySearchTree<Value, KeyOf, Compare>::Find(const Key &key)
+    {
+        NodeType *node = this->FindNode(key);
+        return node == nullptr ? nullptr : node->ReturnValue();
+    }
+
+    // Removes the value with a key. Walks down iteratively while remembering the
+    // path. A node with two children swaps its value with the smallest value of
+    // its right subtree, so the node unlinked never has more than one child. The
+    // path is then walked back up updating heights and counts, rotating where needed;
+    // unlike an insert, a removal can need a rotation at every level.
+    // Parameters:
+    //   key     - The key to remove.
+    //   removed - If not nullptr, receives the removed value.
+    // Returns: True if a value was removed, false if the key does not exist.
+    template <typename Value, typename KeyOf, typename Compare>
+    bool BinarySearchTree<Value, KeyOf, Compare>::Remove(const Key &key, Value *removed)
+    {
+        NodeType *path[MAX_HEIGHT]; // Nodes from the root down to the unlinked node's parent.
+        bool wentLeft[MAX_HEIGHT];  // Direction taken below each node on the path.
+        size_t depth = 0;
+        BST_COUNT(lookups, 1);
+        NodeType *node = this->root.get();
+        while (node != nullptr)
+        {
+            BST_COUNT(lookupNodesVisited, 1);
+            int result = this->CompareKeys(this->keyOf(*node->ReturnValue()), key);
+            if (result == 0)
+            {
+                break;
+            }
+            path[depth] = node;
+            wentLeft[depth] = result > 0;
+            node = wentLeft[depth] ? node->GetLeft() : node->GetRight();
+            depth++;
+        }
+        if (node == nullptr)
+        {
+            return false; // Key does not exist.
+        }
+
+        // Swap the value down to the in-order successor, a node without a left child.
+        if (node->GetLeft() != nullptr && node->GetRight() != nullptr)
+        {
+            NodeType *target = node;
+            path[depth] = node;
+            wentLeft[depth] = false;
+            depth++;
+            node = node->GetRight();
+            while (node->GetLeft() != nullptr)
+            {
+                path[depth] = node;
+                wentLeft[depth] = true;
+                depth++;
+                node = node->GetLeft();
+            }
+            std::swap(*target->ReturnValue(), *node->ReturnValue());
+        }
+
+        // Unlink the node, moving its only child (if any) up into its place.
+        std::unique_ptr<NodeType> child = node->GetLeft() != nullptr ? node->TakeLeft() : node->TakeRight();
+        std::unique_ptr<NodeType> unlinked;
+        if (depth == 0)
+        {
+            unlinked = std::move(this->root);
+            this->root = std::move(child);
+        }
+        else if (wentLeft[depth - 1])
+        {
+            unlinked = path[depth - 1]->TakeLeft();
+            path[depth - 1]->SetLeft(std::move(child));
+        }
+        else
+        {
+            unlinked = path[depth - 1]->TakeRight();
+            path[depth - 1]->SetRight(std::move(child));
+        }
+        if (removed != nullptr)
+        {
+            *removed = std::move(*unlinked->ReturnValue());
+        }
+        unlinked.reset();
+        BST_COUNT(nodeFrees, 1);
+        this->size--;
+
+        // Walk back up, fixing heights and counts and rotating where the balance broke.
+        // Once the balance is settled, the nodes above only need their counts fixed.
+        bool settled = false;
+        for (size_t i = depth; i-- > 0;)
+        {
+            NodeType *current = path[i];
+            int oldHeight = current->GetHeight();
+            current->UpdateSubtree();
+            if (settled)
+            {
+                continue;
+            }
+            int balance = current->GetBalance();
+            if (balance > 1 || balance < -1)
+            {
+                // Detach the subtree from its parent, rotate it and reattach it.
+                if (i == 0)
+                {
+                    this->root = Rebalance(std::move(this->root));
+                    current = this->root.get();
+                }
+                else if (wentLeft[i - 1])
+                {
+                    path[i - 1]->SetLeft(Rebalance(path[i - 1]->TakeLeft()));
+                    current = path[i - 1]->GetLeft();
+                }
+                else
+                {
+                    path[i - 1]->SetRight(Rebalance(path[i - 1]->TakeRight()));
+                    current = path[i - 1]->GetRight();
+                }
+            }
+            if (current->GetHeight() == oldHeight)
+            {
+                settled = true; // Height unchanged, so no balance above can have changed either.
+            }
+        }
+        return true;
+    }
+
+    // Replaces the value with the same key. The key is unchanged, so the node
+    // stays where it is and the tree needs no rebalancing.
+    // Parameters:
+    //   value - The new value.
+    // Returns: True if a value was replaced, false if the key does not exist.
+    template <typename Value, typename KeyOf, typename Compare>
+    bool BinarySearchTree<Value, KeyOf, Compare>::Update(Value value)
+    {
+        NodeType *node = this->FindNode(this->keyOf(value));
+        if (node == nullptr)
+        {
+            return false;
+        }
+        *node->ReturnValue() = std::move(value);
+        return true;
+    }
+
+    // Visits every node of a subtree in order with an explicit stack.
+    // Parameters:
+    //   node  - Root of the subtree to visit, may be nullptr.
+    //   visit - Function called with each node, smallest key first.
+    template <typename Value, typename KeyOf, typename Compare>
+    template <typename Visit>
+    void BinarySearchTree<Value, KeyOf, Compare>::VisitInOrder(NodeType *node, Visit visit)
+    {
+        std::vector<NodeType *> stack;
+        stack.reserve(GetHeight(node));
+        while (node != nullptr || !stack.empty())
+        {
+            while (node != nullptr)
+            {
+                stack.push_back(node);
+                node = node->GetLeft();
+            }
+            node = stack.back();
+            stack.pop_back();
+            visit(node);
+            node = node->GetRight();
+        }
+    }
+
+    // Calls a function with every value in key order.
+    // Parameters:
+    //   visit - Function taking a const reference to a value.
+    template <typename Value, typename KeyOf, typename Compare>
+    template <typename Visit>
+    void BinarySearchTree<Value, KeyOf, Compare>::ForEachInOrder(Visit visit)
+    {
+        this->VisitInOrder(this->root.get(), [&visit](NodeType *current)
+                           { visit(static_cast<const Value &>(*current->ReturnValue())); });
+    }
+
+    // Counts the values with a key less than a key. Every step right skips the
+    // node and its whole left subtree, whose size is stored in the node.
+    // Parameters:
+    //   key - The key to rank, need not be in the tree.
+    // Returns: Number of smaller keys.
+    template <typename Value, typename KeyOf, typename Compare>
+    int BinarySearchTree<Value, KeyOf, Compare>::Rank(const Key &key)
+    {
+        int rank = 0;
+        BST_COUNT(lookups, 1);
+        NodeType *node = this->root.get();
+        while (node != nullptr)
+        {
+            BST_COUNT(lookupNodesVisited, 1);
+            int leftCount = node->GetLeft() != nullptr ? node->GetLeft()->GetCount() : 0;
+            int result = this->CompareKeys(this->keyOf(*node->ReturnValue()), key);
+            if (result == 0)
+            {
+                return rank + leftCount;
+            }
+            if (result > 0)
+            {
+                node = node->GetLeft();
+            }
+            else
+            {
+                rank += leftCount + 1;
+                node = node->GetRight();
+            }
+        }
+        return rank;
+    }
+
+    // Finds the value at a position in key order by comparing the position with
+    // the size of each left subtree on the way down.
+    // Parameters:
+    //   position - Zero-based position, the smallest key is 0.
+    // Returns: Pointer to the value, or nullptr if position is out of range.
+    template <typename Value, typename KeyOf, typename Compare>
+    Value *BinarySearchTree<Value, KeyOf, Compare>::Select(int position)
+    {
+        if (position < 0 || position >= this->size)
+        {
+            return nullptr;
+        }
+        NodeType *node = this->root.get();
+        while (node != nullptr)
+        {
+            int leftCount = node->GetLeft() != nullptr ? node->GetLeft()->GetCount() : 0;
+            if (position == leftCount)
+            {
+                return node->ReturnValue();
+            }
+            if (position < leftCount)
+            {
+                node = node->GetLeft();
+            }
+            else
+            {
+                position -= leftCount + 1;
+                node = node->GetRight();
+            }
+        }
+        return nullptr;
+    }
+
+    // Calls a function with a run of values in key order. The walk down to the
+    // first value leaves the same stack an in-order traversal would have at that
+    // point: every node where the walk went left. Streaming then carries on as in
+    // VisitInOrder, stopping after count values.
+    // Parameters:
+    //   first - Zero-based position of the first value.
+    //   count - Most values to visit.
+    //   visit - Function taking a const reference to a value.
+    // Returns: Number of values visited.
+    template <typename Value, typename KeyOf, typename Compare>
+    template <typename Visit>
+    int BinarySearchTree<Value, KeyOf, Compare>::ForEachInRange(int first, int count, Visit visit)
+    {
+        if (first < 0 || first >= this->size || count <= 0)
+        {
+            return 0;
+        }
+        NodeType *stack[MAX_HEIGHT]; // Ancestors still to visit, nearest last.
+        size_t depth = 0;
+        NodeType *node = this->root.get();
+        int position = first;
+        while (node != nullptr)
+        {
+            int leftCount = node->GetLeft() != nullptr ? node->GetLeft()->GetCount() : 0;
+            if (position > leftCount)
+            {
+                position -= leftCount + 1;
+                node = node->GetRight();
+                continue;
+            }
+            stack[depth++] = node;
+            if (position == leftCount)
+            {
+                break;
+            }
+            node = node->GetLeft();
+        }
+
+        int visited = 0;
+        while (visited < count && depth > 0)
+        {
+            node = stack[--depth];
+            visit(static_cast<const Value &>(*node->ReturnValue()));
+            visited++;
+            for (node = node->GetRight(); node != nullptr; node = node->GetLeft())
+            {
+                stack[depth++] = node;
+            }
+        }
+        return visited;
+    }
+
+    // Returns a copy of every value in the tree, in key order.
+    // Used by tree rebalancing function to get list of values in order.
+    template <typename Value, typename KeyOf, typename Compare>
+    std::vector<Value> BinarySearchTree<Value, KeyOf, Compare>::GetInOrder()
+    {
+        std::vector<Value> values;
+        values.reserve(this->size);
+        this->ForEachInOrder([&values](const Value &value)
+                             { values.push_back(value); });
+        return values;
+    }
+
+    // Clears all nodes in the tree. Node destruction is iterative, so this is
+    // safe for trees of any shape.
+    template <typename Value, typename KeyOf, typename Compare>
+    void BinarySearchTree<Value, KeyOf, Compare>::Clear()
+    {
+        BST_COUNT(nodeFrees, this->size);
+        this->root.reset();
+        this->size = 0; // Reset size to 0.
+    }
+
+    // Rebalances tree by listing it in order. Once ordered vector is built, this
+    // clears BST and loads from middle.
+    template <typename Value, typename KeyOf, typename Compare>
+    void BinarySearchTree<Value, KeyOf, Compare>::RebalanceTree()
+    {
+        // Safety check.
+        if (this->root.get() == nullptr)
+        {
+            return;
+        }
+#ifdef ABCU_STATS
+        auto start = std::chrono::steady_clock::now();
+#endif
+
+        // Built vector in sorted order, moving the values out of the old nodes.
+        std::vector<Value> values;
+        values.reserve(this->size);
+        this->VisitInOrder(this->root.get(), [&values](NodeType *current)
+                           { values.push_back(std::move(*current->ReturnValue())); });
+
+        this->Clear();
+
+        this->root = BuildBalancedTree(values, 0, values.size());
+        this->size = values.size();
+#ifdef ABCU_STATS
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        this->stats.rebalances++;
+        this->stats.rebalanceSeconds += elapsed.count();
+#endif
+    }
+
+    // Replaces the contents of the tree with already sorted, unique values.
+    // Parameters
+    //  values - ordered vector of values, moved into the new nodes.
+    template <typename Value, typename KeyOf, typename Compare>
+    void BinarySearchTree<Value, KeyOf, Compare>::BuildFromSorted(std::vector<Value> values)
+    {
+        this->Clear();
+        this->root = BuildBalancedTree(values, 0, values.size());
+        this->size = values.size();
+    }
+
+    // Called Recursively to build tree balanced. Similar to
+    // Quicksort algorithm where it partitions vector into chunks until it reaches
+    // batches of 1. The recursion depth is only log2 of the number of values.
+    // Parameters
+    //  values - ordered vector of values, each is moved into its node.
+    //  start  - low end of range to work on.
+    //  end  - high end of range to work on.
+    template <typename Value, typename KeyOf, typename Compare>
+    std::unique_ptr<Node<Value>> BinarySearchTree<Value, KeyOf, Compare>::BuildBalancedTree(std::vector<Value> &values, size_t start, size_t end)
+    {
+        if (start >= end || start >= values.size())
+        {
+            return nullptr;
+        }
+
+        size_t mid = start + (end - start) / 2;
+        std::unique_ptr<NodeType> node = std::make_unique<NodeType>(std::in_place, std::move(values[mid]));
+        BST_COUNT(nodeAllocations, 1);
+        node->SetLeft(BuildBalancedTree(values, start, mid));
+        node->SetRight(BuildBalancedTree(values, mid + 1, end));
+        node->UpdateSubtree();
+
+        return node;
+    }
+
+    // Gets the height of the binary search tree from the height kept in each node.
+    // Used for rebalancing logic.
+    // Parameters:
+    //   node   - Root of the subtree to measure.
+    // Returns int (height of tree).
+    template <typename Value, typename KeyOf, typename Compare>
+    int BinarySearchTree<Value, KeyOf, Compare>::GetHeight(NodeType *node)
+    {
+        return node ? node->GetHeight() : 0;
+    }
+
+    // Runs algorithm to decide whether a rebalancing is due. Checks the height of
+    // tree against the log of the size * 2.
+    // Returns bool (to rebalance if true).
+    template <typename Value, typename KeyOf, typename Compare>
+    bool BinarySearchTree<Value, KeyOf, Compare>::IsImbalanced()
+    {
+        int height = GetHeight(root.get());
+        int n = this->size;
+        int logTimesTwo = (std::ceil(std::log2(n)) * 2);
+        return height > logTimesTwo;
+    }
+
+    // Returns the operation counters and the current height.
+    template <typename Value, typename KeyOf, typename Compare>
+    TreeStats BinarySearchTree<Value, KeyOf, Compare>::GetStats()
+    {
+#ifdef ABCU_STATS
+        TreeStats current = this->stats.Load();
+#else
+        TreeStats current;
+#endif
+        current.height = GetHeight(this->root.get());
+        return current;
+    }
+
+    // Resets the operation counters to zero.
+    template <typename Value, typename KeyOf, typename Compare>
+    void BinarySearchTree<Value, KeyOf, Compare>::ResetStats()
+    {
+#ifdef ABCU_STATS
+        this->stats.Store(TreeStats());
+#endif
+    }
+
+    // Prints the operation counters as a small report.
+    template <typename Value, typename KeyOf, typename Compare>
+    void BinarySearchTree<Value, KeyOf, Compare>::PrintStats()
+    {
+        TreeStats current = this->GetStats();
+        std::cout << "------------------------------------------" << std::endl;
+        std::cout << "Entries:              " << this->size << std::endl;
+        std::cout << "Height:               " << current.height << std::endl;
+#ifdef ABCU_STATS
+        double perLookup = current.lookups == 0 ? 0 : double(current.lookupNodesVisited) / current.lookups;
+        std::cout << "Key comparisons:      " << current.comparisons << std::endl;
+        std::cout << "Lookups:              " << current.lookups << std::endl;
+        std::cout << "Nodes per lookup:     " << perLookup << std::endl;
+        std::cout << "Rebalances:           " << current.rebalances << std::endl;
+        std::cout << "Rebalance seconds:    " << current.rebalanceSeconds << std::endl;
+        std::cout << "Node allocations:     " << current.nodeAllocations << std::endl;
+        std::cout << "Node frees:           " << current.nodeFrees << std::endl;
+        std::cout << "Validation passes:    " << current.validations << std::endl;
+#else
+        std::cout << "Operation counters are not compiled in (build with -DABCU_STATS)." << std::endl;
+#endif
+        std::cout << "------------------------------------------" << std::endl;
+    }
+
 } // namespace BST
@@ -0,0 +1,252 @@
+//============================================================================
+// Name        : BackgroundLoader.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Implementation file for the background loader of the ABCU Course
+//               App. The reader and inserter threads share a bounded queue and
+//               only meet the rest of the program through atomics, until Finish
+//               hands the finished tree to the owner.
+//============================================================================
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "BackgroundLoader.hpp"
+#include "CourseLoader.hpp"
+#include "Latency.hpp"
+#include "SpscQueue.hpp"
+
+namespace BST
+{
+
+    namespace
+    {
+        // Parsed courses waiting for the inserter. Enough to keep both threads busy
+        // through short stalls without holding much of the file in memory.
+        const size_t QUEUE_CAPACITY = 4096;
+
+        // A parsed course with the file offset just past its line, for progress.
+        struct QueuedCourse
+        {
+            Course course;          // Parsed course data.
+            uint64_t endOffset = 0; // Bytes of the file up to the end of the line.
+        };
+
+        // State shared by the reader and inserter threads of one load.
+        struct Pipeline
+        {
+            SpscQueue<QueuedCourse> queue{QUEUE_CAPACITY};
+            std::atomic<bool> readerDone{false}; // Set after the reader's last push.
+            std::atomic<bool> readFailed{false}; // Set if the file could not be read.
+        };
+    }
+
+    // Returns the display name of a load stage.
+    // Parameters:
+    //   stage - The stage to name.
+    const char *LoadStageName(LoadStage stage)
+    {
+        switch (stage)
+        {
+        case LoadStage::Idle:
+            return "Idle";
+        case LoadStage::Loading:
+            return "Loading";
+        case LoadStage::Validating:
+            return "Validating";
+        case LoadStage::Done:
+            return "Done";
+        case LoadStage::Cancelled:
+            return "Cancelled";
+        case LoadStage::Failed:
+            return "Failed";
+        }
+        return "Unknown";
+    }
+
+    // Cancels a load still running, so no thread outlives its loader.
+    BackgroundLoader::~BackgroundLoader()
+    {
+        this->cancelled = true;
+        this->Join();
+    }
+
+    // Waits for both threads to exit.
+    void BackgroundLoader::Join()
+    {
+        if (this->reader.joinable())
+        {
+            this->reader.join();
+        }
+        if (this->inserter.joinable())
+        {
+            this->inserter.join();
+        }
+    }
+
+    // Starts loading a course file in the background.
+    // Parameters:
+    //   filePath - The course file to load.
+    // Returns: True if the load started, false if one is already running or the file does not exist.
+    bool BackgroundLoader::Start(const std::string &filePath)
+    {
+        if (this->IsActive() || !std::filesystem::exists(filePath))
+        {
+            return false;
+        }
+        this->staged = std::make_unique<CourseTree>();
+        this->report.str("");
+        this->records = 0;
+        this->bytesDone = 0;
+        this->cancelled = false;
+        this->valid = false;
+        this->totalBytes = std::filesystem::file_size(filePath);
+        this->started = std::chrono::steady_clock::now();
+        this->finishedNanoseconds = 0;
+        this->stage = LoadStage::Loading;
+
+        std::shared_ptr<Pipeline> pipeline = std::make_shared<Pipeline>();
+
+        // Reader: parse each line and push it, waiting while the queue is full.
+        this->reader = std::thread([this, pipeline, filePath]()
+                                   {
+            std::ifstream readfile(filePath);
+            if (readfile.fail())
+            {
+                pipeline->readFailed = true;
+            }
+            std::string line;
+            QueuedCourse next;
+            uint64_t offset = 0;
+            while (!this->cancelled && getline(readfile, line))
+            {
+                offset += line.size() + 1;
+                next.course = Course();
+                ParseCourseLine(line, next.course);
+                next.endOffset = std::min(offset, this->totalBytes);
+                while (!pipeline->queue.TryPush(next))
+                {
+                    if (this->cancelled)
+                    {
+                        return;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+            pipeline->readerDone.store(true, std::memory_order_release); });
+
+        // Inserter: move queued courses into the tree until the reader is done and
+        // the queue is drained, then validate the whole tree as the last stage.
+        this->inserter = std::thread([this, pipeline]()
+                                     {
+            ScopedLatency timer(LatencyOperation::ReadCourseFile);
+            QueuedCourse next;
+            while (!this->cancelled)
+            {
+                if (pipeline->queue.TryPop(next))
+                {
+                    // A rejected course is left untouched, so its ID can be reported.
+                    if (!this->staged->Insert(std::move(next.course)))
+                    {
+                        this->report << "Not inserted: " << next.course.courseId << std::endl;
+                    }
+                    this->records.fetch_add(1, std::memory_order_relaxed);
+                    this->bytesDone.store(next.endOffset, std::memory_order_relaxed);
+                }
+                else if (pipeline->readerDone.load(std::memory_order_acquire))
+                {
+                    if (pipeline->queue.GetSize() == 0)
+                    {
+                        break;
+                    }
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            LoadStage result = LoadStage::Done;
+            if (this->cancelled)
+            {
+                result = LoadStage::Cancelled;
+            }
+            else if (pipeline->readFailed)
+            {
+                result = LoadStage::Failed;
+            }
+            else
+            {
+                this->stage = LoadStage::Validating;
+                this->valid = this->staged->ValidateCourses(this->report);
+            }
+            // The length is stored first so a finished load never reports a running clock.
+            std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - this->started;
+            this->finishedNanoseconds = elapsed.count();
+            this->stage = result; });
+        return true;
+    }
+
+    // Returns the current progress. Safe to call at any time.
+    LoadProgress BackgroundLoader::GetProgress()
+    {
+        LoadProgress progress;
+        progress.stage = this->stage;
+        progress.records = this->records;
+        progress.bytesDone = this->bytesDone;
+        progress.totalBytes = this->totalBytes;
+        int64_t finished = this->finishedNanoseconds;
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - this->started;
+        progress.seconds = finished != 0 ? finished / 1e9 : elapsed.count();
+        if (progress.stage == LoadStage::Idle)
+        {
+            progress.seconds = 0;
+        }
+        return progress;
+    }
+
+    // Returns true between Start and Finish or Cancel.
+    bool BackgroundLoader::IsActive()
+    {
+        return this->stage != LoadStage::Idle;
+    }
+
+    // Returns true once the load has stopped and Finish will not wait.
+    bool BackgroundLoader::IsOver()
+    {
+        LoadStage current = this->stage;
+        return current == LoadStage::Done || current == LoadStage::Cancelled || current == LoadStage::Failed;
+    }
+
+    // Stops the load and discards the tree it was building. Validation is not
+    // interrupted, so a cancel during that stage waits for it to finish.
+    void BackgroundLoader::Cancel()
+    {
+        this->cancelled = true;
+        this->Join();
+        this->staged.reset();
+        this->stage = LoadStage::Idle;
+    }
+
+    // Waits for the load, prints its report and replaces the contents of a tree
+    // with the loaded catalog if it is valid.
+    // Parameters:
+    //   tree - The catalog to replace.
+    // Returns: True if the tree was replaced, false if the load failed, was
+    // cancelled or produced an invalid catalog, which is then discarded.
+    bool BackgroundLoader::Finish(CourseTree &tree)
+    {
+        this->Join();
+        std::cout << this->report.str();
+        bool replaced = this->stage == LoadStage::Done && this->valid && this->staged != nullptr;
+        if (replaced)
+        {
+            tree = std::move(*this->staged);
+        }
+        this->staged.reset();
+        this->stage = LoadStage::Idle;
+        return replaced;
+    }
+
+} // namespace BST
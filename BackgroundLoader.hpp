@@ -0,0 +1,104 @@
+//============================================================================
+// Name        : BackgroundLoader.hpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Header file for the background loader of the ABCU Course App.
+//               A reader thread parses the course file into a lock-free queue
+//               and an inserter thread builds a new tree from it, then validates
+//               it, while the menu keeps serving the catalog already loaded.
+//============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "BST.hpp"
+
+namespace BST
+{
+
+    // Stages of a background load, in the order they happen.
+    enum class LoadStage
+    {
+        Idle,       // No load started since the last one was finished.
+        Loading,    // Reading, parsing and inserting courses.
+        Validating, // Every course is in, checking prerequisites.
+        Done,       // Finished, waiting to replace the catalog.
+        Cancelled,  // Stopped by Cancel, nothing will be replaced.
+        Failed      // The file could not be read.
+    };
+
+    // Returns the display name of a load stage.
+    const char *LoadStageName(LoadStage stage);
+
+    // Snapshot of a background load's progress.
+    struct LoadProgress
+    {
+        LoadStage stage;     // Current stage.
+        uint64_t records;    // Courses read so far, inserted or rejected.
+        uint64_t bytesDone;  // Bytes of the file inserted so far.
+        uint64_t totalBytes; // Size of the file.
+        double seconds;      // Time since the load started, or its total once over.
+    };
+
+    // Loads a whole course file into a new tree on two threads. The reader parses
+    // lines into a bounded SpscQueue and the inserter moves them into the tree, so
+    // parsing and inserting overlap. The tree only replaces the catalog when the
+    // owner calls Finish, which keeps every tree access on the owner's thread.
+    class BackgroundLoader
+    {
+    private:
+        std::unique_ptr<CourseTree> staged; // Tree being built, handed over by Finish.
+        std::ostringstream report;          // Rejected and invalid courses, printed by Finish.
+        std::thread reader;                 // Parses lines into the queue.
+        std::thread inserter;               // Inserts queued courses, then validates.
+        std::atomic<LoadStage> stage{LoadStage::Idle};
+        std::atomic<uint64_t> records{0};    // Courses read, inserted or rejected.
+        std::atomic<uint64_t> bytesDone{0};  // File bytes up to the last inserted course.
+        std::atomic<bool> cancelled{false};  // Set by Cancel, both threads stop at the next record, validation runs to its end.
+        std::atomic<bool> valid{false};      // Result of the validation stage.
+        uint64_t totalBytes = 0;             // File size, fixed at Start.
+        std::chrono::steady_clock::time_point started;
+        std::atomic<int64_t> finishedNanoseconds{0}; // Length of the load once it is over.
+
+        // Waits for both threads to exit.
+        void Join();
+
+    public:
+        ~BackgroundLoader();
+
+        // Starts loading a course file in the background.
+        // Parameters:
+        //   filePath - The course file to load.
+        //   Returns: True if the load started, false if one is already running or
+        //   the file does not exist.
+        bool Start(const std::string &filePath);
+
+        // Returns the current progress. Safe to call at any time.
+        LoadProgress GetProgress();
+
+        // Returns true between Start and Finish or Cancel.
+        bool IsActive();
+
+        // Returns true once the load has stopped and Finish will not wait.
+        bool IsOver();
+
+        // Stops the load and discards the tree it was building. Validation is not
+        // interrupted, so a cancel during that stage waits for it to finish.
+        void Cancel();
+
+        // Waits for the load, prints its report and replaces the contents of a tree
+        // with the loaded catalog if it is valid. An invalid catalog is discarded
+        // and the tree is left as it was.
+        // Parameters:
+        //   tree - The catalog to replace.
+        //   Returns: True if the tree was replaced.
+        bool Finish(CourseTree &tree);
+    };
+
+} // namespace BST
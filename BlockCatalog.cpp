@@ -0,0 +1,925 @@
+//============================================================================
+// Name        : BlockCatalog.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Implementation file for the out-of-core catalog of the ABCU
+//               Course App. Covers the external sort that turns a text course
+//               file into a block file, and the sparse index and LRU block
+//               cache that serve queries from it.
+//============================================================================
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <queue>
+#include "BlockCatalog.hpp"
+#include "CourseLoader.hpp"
+#include "Latency.hpp"
+#include "Snapshot.hpp"
+
+namespace BST
+{
+
+    namespace
+    {
+        // Courses read at a time while validating a new file.
+        const uint64_t VALIDATE_BATCH = 1024;
+
+        // Appends a 16-bit count to an encoded block.
+        // Returns: False if the count does not fit in 16 bits.
+        bool AppendCount(std::string &out, size_t count)
+        {
+            if (count > UINT16_MAX)
+            {
+                return false;
+            }
+            uint16_t value = static_cast<uint16_t>(count);
+            out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+            return true;
+        }
+
+        // Appends a 16-bit length and then the text to an encoded block.
+        // Returns: False if the text is too long to encode.
+        bool AppendText(std::string &out, const std::string &text)
+        {
+            if (!AppendCount(out, text.size()))
+            {
+                return false;
+            }
+            out += text;
+            return true;
+        }
+
+        // Encodes a course as its ID, name, prerequisite count and prerequisite IDs.
+        // Parameters:
+        //   course - The course to encode.
+        //   out    - The encoded block to append to.
+        // Returns: False if a piece of the course is too long to encode.
+        bool EncodeCourse(const Course &course, std::string &out)
+        {
+            bool fits = AppendText(out, course.courseId) && AppendText(out, course.courseName) &&
+                        AppendCount(out, course.prereqs.size());
+            for (const std::string &prereq : course.prereqs)
+            {
+                fits = fits && AppendText(out, prereq);
+            }
+            return fits;
+        }
+
+        // Reads a 16-bit count from an encoded block, advancing the position.
+        // Returns: False if the block ends first.
+        bool ReadCount(const std::string &bytes, size_t &position, uint16_t &count)
+        {
+            if (bytes.size() - position < sizeof(count))
+            {
+                return false;
+            }
+            std::memcpy(&count, bytes.data() + position, sizeof(count));
+            position += sizeof(count);
+            return true;
+        }
+
+        // Reads a 16-bit length and then the text from an encoded block.
+        // Returns: False if the block ends first.
+        bool ReadText(const std::string &bytes, size_t &position, std::string &text)
+        {
+            uint16_t length = 0;
+            if (!ReadCount(bytes, position, length) || bytes.size() - position < length)
+            {
+                return false;
+            }
+            text.assign(bytes, position, length);
+            position += length;
+            return true;
+        }
+
+        // Writes courses in ID order into blocks of a file and builds the block
+        // directory that follows them.
+        struct BlockWriter
+        {
+            std::ofstream &out;      // The block file, positioned after the header.
+            uint32_t blockSize;      // Target size of a block.
+            uint64_t offset;         // File offset of the block being filled.
+            std::string block;       // Encoded courses of the block being filled.
+            std::string firstKey;    // ID of the block's first course.
+            uint32_t blockCourses;   // Courses in the block being filled.
+            std::string directory;   // Directory entries of the finished blocks.
+            uint32_t blockCount;     // Number of finished blocks.
+            uint64_t courseCount;    // Number of courses written.
+            std::string encoded;     // Scratch space for one encoded course.
+
+            BlockWriter(std::ofstream &file, uint32_t size)
+                : out(file), blockSize(size), offset(sizeof(BlockFileHeader)), blockCourses(0), blockCount(0),
+                  courseCount(0)
+            {
+            }
+
+            // Appends a course, first finishing the block if the course would overflow it.
+            // Returns: False if the course is too large to encode.
+            bool Add(const Course &course)
+            {
+                this->encoded.clear();
+                if (!EncodeCourse(course, this->encoded))
+                {
+                    return false;
+                }
+                if (!this->block.empty() && this->block.size() + this->encoded.size() > this->blockSize)
+                {
+                    this->Flush();
+                }
+                if (this->block.empty())
+                {
+                    this->firstKey = course.courseId;
+                }
+                this->block += this->encoded;
+                this->blockCourses++;
+                this->courseCount++;
+                return true;
+            }
+
+            // Writes the block being filled and adds its directory entry.
+            void Flush()
+            {
+                if (this->block.empty())
+                {
+                    return;
+                }
+                BlockDirectoryEntry entry;
+                entry.offset = this->offset;
+                entry.checksum = Fnv1a(this->block.data(), this->block.size());
+                entry.length = static_cast<uint32_t>(this->block.size());
+                entry.courseCount = this->blockCourses;
+                entry.keyLength = static_cast<uint32_t>(this->firstKey.size());
+                entry.reserved = 0;
+                this->directory.append(reinterpret_cast<const char *>(&entry), sizeof(entry));
+                this->directory += this->firstKey;
+
+                this->out.write(this->block.data(), this->block.size());
+                this->offset += this->block.size();
+                this->blockCount++;
+                this->block.clear();
+                this->blockCourses = 0;
+            }
+        };
+
+        // Writes a sorted run of courses as course file lines.
+        // Returns: True if the run file was written.
+        bool WriteRun(const std::string &runPath, const std::vector<Course> &courses)
+        {
+            std::ofstream out(runPath, std::ios::trunc);
+            for (const Course &course : courses)
+            {
+                out << course.courseId << "," << course.courseName;
+                for (const std::string &prereq : course.prereqs)
+                {
+                    out << "," << prereq;
+                }
+                out << "\n";
+            }
+            return out.good();
+        }
+
+        // The next course of one sorted run during the merge.
+        struct RunHead
+        {
+            Course course; // The run's smallest course not yet merged.
+            size_t run;    // Index of the run, lower runs come earlier in the file.
+        };
+
+        // A course's reference to one of its prerequisites.
+        struct Reference
+        {
+            std::string prereq;   // The prerequisite ID.
+            std::string courseId; // The course listing it.
+            size_t run = 0;       // Index of the run it was read from, during the merge.
+        };
+
+        // Sorts references by prerequisite and writes them as "prereq,courseId" lines.
+        // Returns: True if the run file was written.
+        bool WriteReferenceRun(const std::string &runPath, std::vector<Reference> &references)
+        {
+            NoCaseCompare compare;
+            std::sort(references.begin(), references.end(), [&compare](const Reference &first, const Reference &second)
+                      { return compare(first.prereq, second.prereq) < 0; });
+            std::ofstream out(runPath, std::ios::trunc);
+            for (const Reference &reference : references)
+            {
+                out << reference.prereq << "," << reference.courseId << "\n";
+            }
+            references.clear();
+            return out.good();
+        }
+    }
+
+    // Converts a text course file into a block file in three passes: sorted runs
+    // of at most runCourses courses go to temporary files, the runs are merged
+    // into blocks along with sorted runs of prerequisite references, and the
+    // references are merged against the finished file to validate it.
+    // Parameters:
+    //   textPath   - The course file to convert.
+    //   blockPath  - Path of the block file to write.
+    //   runCourses - Most courses held in memory at once while sorting.
+    //   blockSize  - Target size of a block in bytes.
+    // Returns: True if the block file was written and the catalog is valid.
+    bool BuildBlockFile(const std::string &textPath, const std::string &blockPath, size_t runCourses,
+                        uint32_t blockSize)
+    {
+        ScopedLatency timer(LatencyOperation::ReadCourseFile);
+        std::ifstream text(textPath);
+        if (text.fail())
+        {
+            std::cerr << "Error, File doesn't exist." << std::endl;
+            return false;
+        }
+        runCourses = std::max<size_t>(1, runCourses);
+
+        // Pass 1: sort runs of the file in memory. The sort is stable, so courses
+        // with the same ID stay in file order within a run.
+        NoCaseCompare compare;
+        auto idLess = [&compare](const Course &first, const Course &second)
+        { return compare(first.courseId, second.courseId) < 0; };
+        std::vector<std::string> runPaths;
+        std::vector<Course> run;
+        std::string line;
+        bool readAll = false;
+        bool written = true;
+        while (!readAll)
+        {
+            readAll = !getline(text, line);
+            if (!readAll)
+            {
+                run.emplace_back();
+                ParseCourseLine(line, run.back());
+            }
+            if (run.size() == runCourses || (readAll && !run.empty()))
+            {
+                std::stable_sort(run.begin(), run.end(), idLess);
+                runPaths.push_back(blockPath + ".run" + std::to_string(runPaths.size()));
+                written = WriteRun(runPaths.back(), run) && written;
+                run.clear();
+            }
+        }
+        run.shrink_to_fit();
+
+        // Pass 2: merge the runs into blocks, keeping the first course with each ID.
+        std::ofstream out(blockPath, std::ios::binary | std::ios::trunc);
+        BlockFileHeader header = {};
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        BlockWriter writer(out, std::max<uint32_t>(1, blockSize));
+
+        std::vector<std::ifstream> runs;
+        for (const std::string &runPath : runPaths)
+        {
+            runs.emplace_back(runPath);
+        }
+        auto later = [&compare](const RunHead &first, const RunHead &second)
+        {
+            int result = compare(first.course.courseId, second.course.courseId);
+            return result != 0 ? result > 0 : first.run > second.run;
+        };
+        std::priority_queue<RunHead, std::vector<RunHead>, decltype(later)> heads(later);
+        auto advance = [&runs, &heads, &line](size_t index)
+        {
+            if (getline(runs[index], line))
+            {
+                RunHead head;
+                ParseCourseLine(line, head.course);
+                head.run = index;
+                heads.push(std::move(head));
+            }
+        };
+        for (size_t i = 0; i < runs.size(); i++)
+        {
+            advance(i);
+        }
+
+        // Every prerequisite reference is also written out in runs sorted by
+        // prerequisite, for the validation pass.
+        bool isGood = true;
+        std::string lastId;
+        std::vector<Reference> references;
+        std::vector<std::string> referencePaths;
+        while (!heads.empty())
+        {
+            RunHead head = heads.top();
+            heads.pop();
+            advance(head.run);
+            if (writer.courseCount > 0 && compare(head.course.courseId, lastId) == 0)
+            {
+                std::cout << "Not inserted: " << head.course.courseId << std::endl;
+                continue;
+            }
+            lastId = head.course.courseId;
+            isGood = CourseTree::HasValidLengths(head.course.courseId, head.course.courseName) && isGood;
+            written = writer.Add(head.course) && written;
+            for (const std::string &prereq : head.course.prereqs)
+            {
+                references.push_back({prereq, head.course.courseId});
+                if (references.size() == runCourses)
+                {
+                    referencePaths.push_back(blockPath + ".ref" + std::to_string(referencePaths.size()));
+                    written = WriteReferenceRun(referencePaths.back(), references) && written;
+                }
+            }
+        }
+        writer.Flush();
+        if (!references.empty())
+        {
+            referencePaths.push_back(blockPath + ".ref" + std::to_string(referencePaths.size()));
+            written = WriteReferenceRun(referencePaths.back(), references) && written;
+        }
+        references.shrink_to_fit();
+        runs.clear();
+        for (const std::string &runPath : runPaths)
+        {
+            std::remove(runPath.c_str());
+        }
+        auto removeReferences = [&referencePaths]()
+        {
+            for (const std::string &referencePath : referencePaths)
+            {
+                std::remove(referencePath.c_str());
+            }
+        };
+
+        std::memcpy(header.magic, "ABCUBLKS", sizeof(header.magic));
+        header.version = BLOCK_FILE_VERSION;
+        header.blockCount = writer.blockCount;
+        header.courseCount = writer.courseCount;
+        header.directoryOffset = writer.offset;
+        header.directoryLength = writer.directory.size();
+        header.directoryChecksum = Fnv1a(writer.directory.data(), writer.directory.size());
+        out.write(writer.directory.data(), writer.directory.size());
+        out.seekp(0);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.close();
+        if (!written || out.fail())
+        {
+            std::cerr << "Block file not written, a course is too long or the disk is full." << std::endl;
+            removeReferences();
+            std::remove(blockPath.c_str());
+            return false;
+        }
+
+        // Pass 3: check every prerequisite exists by merging the references, in
+        // prerequisite order, with the courses read from the new file in ID order.
+        // Both sides are read sequentially, so no prerequisite needs a lookup.
+        BlockCatalog catalog;
+        if (!catalog.Open(blockPath))
+        {
+            removeReferences();
+            std::remove(blockPath.c_str());
+            return false;
+        }
+        std::vector<std::ifstream> referenceRuns;
+        for (const std::string &referencePath : referencePaths)
+        {
+            referenceRuns.emplace_back(referencePath);
+        }
+        auto referenceLater = [&compare](const Reference &first, const Reference &second)
+        { return compare(first.prereq, second.prereq) > 0; };
+        std::priority_queue<Reference, std::vector<Reference>, decltype(referenceLater)> nextReferences(referenceLater);
+        auto advanceReference = [&referenceRuns, &nextReferences, &line](size_t index)
+        {
+            if (getline(referenceRuns[index], line))
+            {
+                size_t comma = line.find(',');
+                Reference reference;
+                reference.prereq = line.substr(0, comma);
+                reference.courseId = comma == std::string::npos ? "" : line.substr(comma + 1);
+                reference.run = index;
+                nextReferences.push(std::move(reference));
+            }
+        };
+        for (size_t i = 0; i < referenceRuns.size(); i++)
+        {
+            advanceReference(i);
+        }
+
+        std::vector<std::string> badCourses;
+        std::vector<Course> batch;
+        size_t batchPosition = 0;
+        uint64_t nextPosition = 0;
+        while (!nextReferences.empty())
+        {
+            Reference reference = nextReferences.top();
+            nextReferences.pop();
+            advanceReference(reference.run);
+
+            // Move the course cursor up to the first ID not less than the prerequisite.
+            while (true)
+            {
+                if (batchPosition == batch.size())
+                {
+                    batch = catalog.GetCoursesInRange(nextPosition, VALIDATE_BATCH);
+                    batchPosition = 0;
+                    nextPosition += batch.size();
+                    if (batch.empty())
+                    {
+                        break;
+                    }
+                }
+                if (compare(batch[batchPosition].courseId, reference.prereq) >= 0)
+                {
+                    break;
+                }
+                batchPosition++;
+            }
+            if (batch.empty() || compare(batch[batchPosition].courseId, reference.prereq) != 0)
+            {
+                badCourses.push_back(reference.courseId);
+            }
+        }
+        catalog.Close();
+        referenceRuns.clear();
+        removeReferences();
+
+        // Report every course with a missing prerequisite once, in order.
+        std::sort(badCourses.begin(), badCourses.end(), [&compare](const std::string &first, const std::string &second)
+                  { return compare(first, second) < 0; });
+        badCourses.erase(std::unique(badCourses.begin(), badCourses.end()), badCourses.end());
+        for (const std::string &courseId : badCourses)
+        {
+            std::cout << "Bad Course: " << courseId << std::endl;
+            isGood = false;
+        }
+        if (!isGood)
+        {
+            std::remove(blockPath.c_str());
+        }
+        return isGood;
+    }
+
+    // BlockCatalog class implementation.
+
+    // Constructor: Initializes a catalog with no file open.
+    BlockCatalog::BlockCatalog()
+    {
+        this->courseCount = 0;
+        this->cacheCapacity = DEFAULT_CACHE_BLOCKS;
+    }
+
+    // Opens a block file, checks its header and directory checksum and reads the
+    // directory into the sparse index. Blocks are only read by queries.
+    // Parameters:
+    //   filePath    - Path of the block file.
+    //   cacheBlocks - Most blocks to keep in the cache, at least 1.
+    // Returns: True if the file is usable, false if missing or corrupt.
+    bool BlockCatalog::Open(const std::string &filePath, size_t cacheBlocks)
+    {
+        this->Close();
+        this->file.open(filePath, std::ios::binary);
+        BlockFileHeader header;
+        if (!this->file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+            std::memcmp(header.magic, "ABCUBLKS", sizeof(header.magic)) != 0 || header.version != BLOCK_FILE_VERSION)
+        {
+            this->Close();
+            return false;
+        }
+
+        // Check the header against the file size before trusting its lengths, so
+        // a corrupt header cannot make the directory allocation huge.
+        this->file.seekg(0, std::ios::end);
+        uint64_t fileSize = static_cast<uint64_t>(this->file.tellg());
+        if (!this->file || header.directoryOffset < sizeof(header) || header.directoryOffset > fileSize ||
+            header.directoryLength > fileSize - header.directoryOffset ||
+            header.directoryLength / sizeof(BlockDirectoryEntry) < header.blockCount)
+        {
+            this->Close();
+            return false;
+        }
+
+        std::string directory(header.directoryLength, '\0');
+        this->file.seekg(header.directoryOffset);
+        if (!this->file.read(directory.data(), directory.size()) ||
+            Fnv1a(directory.data(), directory.size()) != header.directoryChecksum)
+        {
+            this->Close();
+            return false;
+        }
+
+        size_t position = 0;
+        uint64_t courses = 0;
+        this->blocks.reserve(header.blockCount);
+        for (uint32_t i = 0; i < header.blockCount; i++)
+        {
+            BlockDirectoryEntry entry;
+            if (directory.size() - position < sizeof(entry))
+            {
+                this->Close();
+                return false;
+            }
+            std::memcpy(&entry, directory.data() + position, sizeof(entry));
+            position += sizeof(entry);
+            if (directory.size() - position < entry.keyLength || entry.offset < sizeof(header) ||
+                entry.offset > header.directoryOffset || entry.length > header.directoryOffset - entry.offset)
+            {
+                this->Close();
+                return false;
+            }
+            BlockInfo info;
+            info.firstKey.assign(directory, position, entry.keyLength);
+            info.offset = entry.offset;
+            info.checksum = entry.checksum;
+            info.length = entry.length;
+            info.courseCount = entry.courseCount;
+            info.firstPosition = courses;
+            position += entry.keyLength;
+            courses += entry.courseCount;
+            this->blocks.push_back(std::move(info));
+        }
+        if (courses != header.courseCount)
+        {
+            this->Close();
+            return false;
+        }
+        this->courseCount = courses;
+        this->cacheCapacity = std::max<size_t>(1, cacheBlocks);
+        return true;
+    }
+
+    // Closes the file and drops the sparse index and the cache.
+    void BlockCatalog::Close()
+    {
+        if (this->file.is_open())
+        {
+            this->file.close();
+        }
+        this->file.clear();
+        this->blocks.clear();
+        this->blocks.shrink_to_fit();
+        this->cache.clear();
+        this->cachedBlocks.clear();
+        this->courseCount = 0;
+        this->stats = BlockCacheStats();
+    }
+
+    // Returns true while a block file is open.
+    bool BlockCatalog::IsOpen()
+    {
+        return this->file.is_open();
+    }
+
+    // Returns the number of courses in the file.
+    int BlockCatalog::GetSize()
+    {
+        return static_cast<int>(this->courseCount);
+    }
+
+    // Returns the number of blocks in the file.
+    size_t BlockCatalog::GetBlockCount()
+    {
+        return this->blocks.size();
+    }
+
+    // Reads, checks and decodes one block from the file.
+    // Parameters:
+    //   index   - Index of the block.
+    //   courses - Receives the block's courses.
+    // Returns: True if the block was read and its checksum matches.
+    bool BlockCatalog::ReadBlock(uint32_t index, std::vector<Course> &courses)
+    {
+        const BlockInfo &info = this->blocks[index];
+        std::string bytes(info.length, '\0');
+        this->file.clear();
+        this->file.seekg(info.offset);
+        bool read = static_cast<bool>(this->file.read(bytes.data(), bytes.size()));
+        this->stats.bytesRead += info.length;
+        if (!read || Fnv1a(bytes.data(), bytes.size()) != info.checksum)
+        {
+            std::cerr << "Block " << index << " of the catalog file is corrupt." << std::endl;
+            return false;
+        }
+
+        courses.clear();
+        courses.resize(info.courseCount);
+        size_t position = 0;
+        for (Course &course : courses)
+        {
+            uint16_t prereqCount = 0;
+            if (!ReadText(bytes, position, course.courseId) || !ReadText(bytes, position, course.courseName) ||
+                !ReadCount(bytes, position, prereqCount))
+            {
+                return false;
+            }
+            course.prereqs.resize(prereqCount);
+            for (std::string &prereq : course.prereqs)
+            {
+                if (!ReadText(bytes, position, prereq))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Returns a block's courses through the cache. A hit moves the block to the
+    // front of the recency list; a miss reads it and evicts the block at the back
+    // once the cache is full.
+    // Parameters:
+    //   index - Index of the block.
+    // Returns: The block's courses, or nullptr if the block is corrupt.
+    const std::vector<Course> *BlockCatalog::GetBlock(uint32_t index)
+    {
+        this->stats.blockReads++;
+        auto found = this->cachedBlocks.find(index);
+        if (found != this->cachedBlocks.end())
+        {
+            this->stats.hits++;
+            this->cache.splice(this->cache.begin(), this->cache, found->second);
+            return &found->second->courses;
+        }
+
+        CachedBlock block;
+        block.index = index;
+        if (!this->ReadBlock(index, block.courses))
+        {
+            return nullptr;
+        }
+        if (this->cache.size() >= this->cacheCapacity)
+        {
+            this->cachedBlocks.erase(this->cache.back().index);
+            this->cache.pop_back();
+        }
+        this->cache.push_front(std::move(block));
+        this->cachedBlocks[index] = this->cache.begin();
+        return &this->cache.front().courses;
+    }
+
+    // Finds the only block that can hold an ID with a binary search of the
+    // sparse index for the first block starting after the ID.
+    // Parameters:
+    //   courseId - The course ID.
+    // Returns: Index of the block, 0 if the ID sorts before every block.
+    uint32_t BlockCatalog::FindBlock(std::string_view courseId)
+    {
+        NoCaseCompare compare;
+        auto after = std::upper_bound(this->blocks.begin(), this->blocks.end(), courseId,
+                                      [&compare](std::string_view id, const BlockInfo &block)
+                                      { return compare(id, block.firstKey) < 0; });
+        return after == this->blocks.begin() ? 0 : static_cast<uint32_t>(after - this->blocks.begin() - 1);
+    }
+
+    // Finds the block holding a position in ID order: the last block starting at
+    // or before it.
+    // Parameters:
+    //   position - Position of a course, less than the course count.
+    // Returns: Index of the block.
+    uint32_t BlockCatalog::BlockAt(uint64_t position)
+    {
+        auto after = std::upper_bound(this->blocks.begin(), this->blocks.end(), position,
+                                      [](uint64_t wanted, const BlockInfo &block)
+                                      { return wanted < block.firstPosition; });
+        return static_cast<uint32_t>(after - this->blocks.begin() - 1);
+    }
+
+    // Returns the course at a position in ID order through the cache.
+    // Parameters:
+    //   position - Position of a course, less than the course count.
+    // Returns: The course, valid until another block is read, or nullptr if its
+    //          block is corrupt.
+    const Course *BlockCatalog::CourseAt(uint64_t position)
+    {
+        uint32_t index = this->BlockAt(position);
+        const std::vector<Course> *courses = this->GetBlock(index);
+        if (courses == nullptr)
+        {
+            return nullptr;
+        }
+        return &(*courses)[position - this->blocks[index].firstPosition];
+    }
+
+    // Visits a run of courses in ID order. The first block is found by a binary
+    // search of the block start positions, then blocks are read in order until
+    // the run is done.
+    // Parameters:
+    //   first - Position of the first course.
+    //   count - Most courses to visit.
+    //   visit - Function called with each course.
+    template <typename Visit>
+    void BlockCatalog::VisitRange(uint64_t first, uint64_t count, Visit visit)
+    {
+        this->stats.queries++;
+        if (first >= this->courseCount || count == 0)
+        {
+            return;
+        }
+        uint32_t index = this->BlockAt(first);
+        uint64_t skip = first - this->blocks[index].firstPosition;
+        for (; index < this->blocks.size() && count > 0; index++)
+        {
+            const std::vector<Course> *courses = this->GetBlock(index);
+            if (courses == nullptr)
+            {
+                return;
+            }
+            for (size_t i = skip; i < courses->size() && count > 0; i++, count--)
+            {
+                visit((*courses)[i]);
+            }
+            skip = 0;
+        }
+    }
+
+    // Searches for a course by ID (case-insensitive), reading at most one block.
+    // Parameters:
+    //   courseId - The course ID to search for.
+    //   course   - Reference to a Course object to store the found course.
+    // Returns: True if the course was found.
+    bool BlockCatalog::FindCourse(const std::string &courseId, Course &course)
+    {
+        this->stats.queries++;
+        if (this->blocks.empty())
+        {
+            return false;
+        }
+        const std::vector<Course> *courses = this->GetBlock(this->FindBlock(courseId));
+        if (courses == nullptr)
+        {
+            return false;
+        }
+        NoCaseCompare compare;
+        auto found = std::lower_bound(courses->begin(), courses->end(), courseId,
+                                      [&compare](const Course &candidate, const std::string &id)
+                                      { return compare(candidate.courseId, id) < 0; });
+        if (found == courses->end() || compare(found->courseId, courseId) != 0)
+        {
+            return false;
+        }
+        course = *found;
+        return true;
+    }
+
+    // Counts the courses with an ID less than an ID: the courses of the blocks
+    // before its block plus those before it in its block.
+    // Parameters:
+    //   courseId - The course ID to rank, need not be in the file.
+    //   rank     - Receives the number of smaller IDs.
+    // Returns: True if counted, false if the block holding the ID is corrupt.
+    bool BlockCatalog::Rank(const std::string &courseId, uint64_t &rank)
+    {
+        this->stats.queries++;
+        rank = 0;
+        if (this->blocks.empty())
+        {
+            return true;
+        }
+        uint32_t index = this->FindBlock(courseId);
+        const std::vector<Course> *courses = this->GetBlock(index);
+        if (courses == nullptr)
+        {
+            return false;
+        }
+        NoCaseCompare compare;
+        auto found = std::lower_bound(courses->begin(), courses->end(), courseId,
+                                      [&compare](const Course &candidate, const std::string &id)
+                                      { return compare(candidate.courseId, id) < 0; });
+        rank = this->blocks[index].firstPosition + (found - courses->begin());
+        return true;
+    }
+
+    // Returns the course IDs closest to one that was not found. The IDs of the
+    // file are in order, so the suggestion walk reads them by position through
+    // the cache; neighbouring positions share a block, so the walk reads only
+    // the blocks around the prefixes close to the query.
+    // Parameters:
+    //   courseId - The mistyped course ID.
+    //   limit    - Most suggestions to return.
+    // Returns: Suggested IDs, closest first, or none if a block is corrupt.
+    std::vector<std::string> BlockCatalog::SuggestIds(const std::string &courseId, size_t limit)
+    {
+        ScopedLatency timer(LatencyOperation::Suggest);
+        bool corrupt = false;
+        auto idAt = [this, &corrupt](size_t position) -> std::string
+        {
+            const Course *course = this->CourseAt(position);
+            if (course == nullptr)
+            {
+                corrupt = true;
+                return "";
+            }
+            return course->courseId;
+        };
+        std::vector<std::pair<int, size_t>> found = SuggestSortedIds<NoCaseCompare>(
+            this->courseCount, idAt, [](size_t)
+            { return true; },
+            courseId, limit);
+        std::vector<std::string> suggestions;
+        for (size_t i = 0; i < found.size() && !corrupt; i++)
+        {
+            suggestions.push_back(idAt(found[i].second));
+        }
+        if (corrupt)
+        {
+            suggestions.clear();
+        }
+        return suggestions;
+    }
+
+    // Returns copies of a run of courses in ID order, reading only its blocks.
+    // Parameters:
+    //   first - Zero-based position of the first course.
+    //   count - Most courses to return.
+    std::vector<Course> BlockCatalog::GetCoursesInRange(uint64_t first, uint64_t count)
+    {
+        std::vector<Course> courses;
+        this->VisitRange(first, count, [&courses](const Course &course)
+                         { courses.push_back(course); });
+        return courses;
+    }
+
+    // Prints all courses in sorted order. Blocks are read one at a time straight
+    // from the file, so a full listing does not evict the cached blocks.
+    void BlockCatalog::PrintOrdered()
+    {
+        ScopedLatency timer(LatencyOperation::PrintOrdered);
+        this->stats.queries++;
+        std::vector<Course> courses;
+        for (uint32_t i = 0; i < this->blocks.size(); i++)
+        {
+            this->stats.blockReads++;
+            if (!this->ReadBlock(i, courses))
+            {
+                return;
+            }
+            for (const Course &course : courses)
+            {
+                CourseTree::PrintIdDescription(course);
+            }
+        }
+    }
+
+    // Prints details of a single course by ID.
+    // Parameters:
+    //   courseId - The course ID to print.
+    void BlockCatalog::PrintSingleCourse(std::string courseId)
+    {
+        ScopedLatency timer(LatencyOperation::Lookup);
+        Course course;
+        if (this->FindCourse(courseId, course))
+        {
+            CourseTree::PrintCourse(course);
+        }
+        else
+        {
+            CourseTree::PrintNotFound(this->SuggestIds(courseId));
+        }
+    }
+
+    // Prints the ID and name of the courses on one page of the ordered list,
+    // followed by the page number and the page count.
+    // Parameters:
+    //   page     - One-based page number.
+    //   pageSize - Courses per page.
+    void BlockCatalog::PrintPage(int page, int pageSize)
+    {
+        ScopedLatency timer(LatencyOperation::Page);
+        uint64_t pageCount = pageSize > 0 ? (this->courseCount + pageSize - 1) / pageSize : 0;
+        if (page < 1 || static_cast<uint64_t>(page) > pageCount)
+        {
+            std::cout << "Page not found." << std::endl;
+            return;
+        }
+        this->VisitRange(static_cast<uint64_t>(page - 1) * pageSize, pageSize, [](const Course &course)
+                         { CourseTree::PrintIdDescription(course); });
+        std::cout << "Page " << page << " of " << pageCount << std::endl;
+    }
+
+    // Returns the cache and I/O counters.
+    BlockCacheStats BlockCatalog::GetCacheStats()
+    {
+        return this->stats;
+    }
+
+    // Resets the cache and I/O counters to zero. Cached blocks are kept.
+    void BlockCatalog::ResetCacheStats()
+    {
+        this->stats = BlockCacheStats();
+    }
+
+    // Prints the sparse index size, cache hit rate and bytes read per query.
+    void BlockCatalog::PrintCacheStats()
+    {
+        size_t indexBytes = this->blocks.size() * sizeof(BlockInfo);
+        for (const BlockInfo &block : this->blocks)
+        {
+            indexBytes += block.firstKey.size();
+        }
+        double hitRate = this->stats.blockReads == 0 ? 0 : 100.0 * this->stats.hits / this->stats.blockReads;
+        double perQuery = this->stats.queries == 0 ? 0 : double(this->stats.bytesRead) / this->stats.queries;
+        std::cout << "------------------------------------------" << std::endl;
+        std::cout << "Courses:              " << this->courseCount << std::endl;
+        std::cout << "Blocks:               " << this->blocks.size() << std::endl;
+        std::cout << "Sparse index bytes:   " << indexBytes << std::endl;
+        std::cout << "Cached blocks:        " << this->cache.size() << " of " << this->cacheCapacity << std::endl;
+        std::cout << "Queries:              " << this->stats.queries << std::endl;
+        std::cout << "Block reads:          " << this->stats.blockReads << std::endl;
+        std::cout << "Cache hit rate:       " << hitRate << "%" << std::endl;
+        std::cout << "Bytes read:           " << this->stats.bytesRead << std::endl;
+        std::cout << "Bytes read per query: " << perQuery << std::endl;
+        std::cout << "------------------------------------------" << std::endl;
+    }
+
+} // namespace BST
@@ -0,0 +1,242 @@
+//============================================================================
+// Name        : BlockCatalog.hpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Header file for the out-of-core catalog of the ABCU Course App.
+//               Courses are stored sorted in fixed-size blocks of a file, and
+//               only a sparse index of the first ID of every block stays in
+//               memory. Lookups and listings read just the blocks they need
+//               through a bounded LRU cache, so the catalog can be larger than RAM.
+//============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "BST.hpp"
+
+namespace BST
+{
+
+    // Current block file format version. Files with any other version are rejected.
+    const uint32_t BLOCK_FILE_VERSION = 1;
+
+    // Target size of a block in bytes. A block ends before the course that would
+    // overflow it, so only a course larger than this gets a longer block of its own.
+    const uint32_t DEFAULT_BLOCK_SIZE = 4096;
+
+    // Blocks kept in the cache by default, 256 KB of encoded courses.
+    const size_t DEFAULT_CACHE_BLOCKS = 64;
+
+    // Fixed header at the start of a block file. It is followed by the blocks and
+    // then the block directory, which is read into the sparse index by Open.
+    struct BlockFileHeader
+    {
+        char magic[8];              // Always "ABCUBLKS".
+        uint32_t version;           // Format version, see BLOCK_FILE_VERSION.
+        uint32_t blockCount;        // Number of blocks and directory entries.
+        uint64_t courseCount;       // Number of courses in every block.
+        uint64_t directoryOffset;   // Offset of the block directory in the file.
+        uint64_t directoryLength;   // Size of the block directory in bytes.
+        uint64_t directoryChecksum; // FNV-1a hash of the block directory.
+    };
+
+    // One block directory entry, followed in the file by the block's first course ID.
+    struct BlockDirectoryEntry
+    {
+        uint64_t offset;      // Offset of the block in the file.
+        uint64_t checksum;    // FNV-1a hash of the block, checked on every read.
+        uint32_t length;      // Size of the block in bytes.
+        uint32_t courseCount; // Number of courses in the block.
+        uint32_t keyLength;   // Length of the first course ID that follows the entry.
+        uint32_t reserved;    // Always 0, keeps the entry 8-byte aligned.
+    };
+
+    // Cache and I/O counters of a block catalog since it was opened or reset.
+    struct BlockCacheStats
+    {
+        uint64_t queries = 0;    // Lookups, ranks and range listings answered.
+        uint64_t blockReads = 0; // Blocks the queries needed.
+        uint64_t hits = 0;       // Needed blocks that were already in the cache.
+        uint64_t bytesRead = 0;  // Block bytes read from the file, full listings included.
+    };
+
+    // Converts a text course file into a block file without holding the whole
+    // catalog in memory. Sorted runs of courses are written to temporary files
+    // next to the block file and merged into blocks. The first course with an
+    // ID is kept and later ones are reported, as the loaders do. Prerequisite
+    // references are sorted the same way and merged against the finished file,
+    // reporting every course with a missing prerequisite like ValidateCourses,
+    // and the file is removed if the catalog is invalid.
+    // Parameters:
+    //   textPath   - The course file to convert.
+    //   blockPath  - Path of the block file to write.
+    //   runCourses - Most courses held in memory at once while sorting.
+    //   blockSize  - Target size of a block in bytes.
+    // Returns: True if the block file was written and the catalog is valid.
+    bool BuildBlockFile(const std::string &textPath, const std::string &blockPath, size_t runCourses = 100000,
+                        uint32_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    // Read-only catalog served from a block file. Only the sparse index and the
+    // cached blocks are in memory.
+    class BlockCatalog
+    {
+    private:
+        // Sparse index entry of one block.
+        struct BlockInfo
+        {
+            std::string firstKey;   // ID of the block's first course.
+            uint64_t offset;        // Offset of the block in the file.
+            uint64_t checksum;      // FNV-1a hash of the block.
+            uint32_t length;        // Size of the block in bytes.
+            uint32_t courseCount;   // Number of courses in the block.
+            uint64_t firstPosition; // Position in ID order of the block's first course.
+        };
+
+        // A decoded block held by the cache.
+        struct CachedBlock
+        {
+            uint32_t index;              // Index of the block.
+            std::vector<Course> courses; // The block's courses in ID order.
+        };
+
+        std::ifstream file;            // The open block file.
+        std::vector<BlockInfo> blocks; // Sparse index, one entry per block.
+        uint64_t courseCount;          // Number of courses in the file.
+        size_t cacheCapacity;          // Most blocks kept in the cache.
+        std::list<CachedBlock> cache;  // Cached blocks, most recently used first.
+        std::unordered_map<uint32_t, std::list<CachedBlock>::iterator> cachedBlocks; // Cache entry of each cached block.
+        BlockCacheStats stats;         // Counters since Open or ResetCacheStats.
+
+        // Reads, checks and decodes one block from the file.
+        // Parameters:
+        //   index   - Index of the block.
+        //   courses - Receives the block's courses.
+        //   Returns: True if the block was read and its checksum matches.
+        bool ReadBlock(uint32_t index, std::vector<Course> &courses);
+
+        // Returns a block's courses through the cache, reading the block on a miss
+        // and evicting the least recently used block when the cache is full.
+        // Parameters:
+        //   index - Index of the block.
+        //   Returns: The block's courses, or nullptr if the block is corrupt.
+        const std::vector<Course> *GetBlock(uint32_t index);
+
+        // Finds the only block that can hold an ID: the last one whose first ID is
+        // not greater than it, using a binary search of the sparse index.
+        // Parameters:
+        //   courseId - The course ID.
+        //   Returns: Index of the block, 0 if the ID sorts before every block.
+        uint32_t FindBlock(std::string_view courseId);
+
+        // Finds the block holding a position in ID order, using a binary search of
+        // the block start positions.
+        // Parameters:
+        //   position - Position of a course, less than the course count.
+        //   Returns: Index of the block.
+        uint32_t BlockAt(uint64_t position);
+
+        // Returns the course at a position in ID order, reading its block through
+        // the cache.
+        // Parameters:
+        //   position - Position of a course, less than the course count.
+        //   Returns: The course, valid until another block is read, or nullptr if
+        //            its block is corrupt.
+        const Course *CourseAt(uint64_t position);
+
+        // Visits a run of courses in ID order, starting at a position, reading
+        // only the blocks the run covers.
+        // Parameters:
+        //   first - Position of the first course.
+        //   count - Most courses to visit.
+        //   visit - Function called with each course.
+        template <typename Visit>
+        void VisitRange(uint64_t first, uint64_t count, Visit visit);
+
+    public:
+        // Constructor: Initializes a catalog with no file open.
+        BlockCatalog();
+
+        BlockCatalog(const BlockCatalog &) = delete;
+        BlockCatalog &operator=(const BlockCatalog &) = delete;
+
+        // Opens a block file and reads its directory into the sparse index.
+        // Parameters:
+        //   filePath    - Path of the block file.
+        //   cacheBlocks - Most blocks to keep in the cache, at least 1.
+        //   Returns: True if the file is usable, false if missing or corrupt.
+        bool Open(const std::string &filePath, size_t cacheBlocks = DEFAULT_CACHE_BLOCKS);
+
+        // Closes the file and drops the sparse index and the cache.
+        void Close();
+
+        // Returns true while a block file is open.
+        bool IsOpen();
+
+        // Returns the number of courses in the file.
+        int GetSize();
+
+        // Returns the number of blocks in the file.
+        size_t GetBlockCount();
+
+        // Searches for a course by ID (case-insensitive), reading at most one block.
+        // Parameters:
+        //   courseId - The course ID to search for.
+        //   course   - Reference to a Course object to store the found course.
+        //   Returns: True if the course was found.
+        bool FindCourse(const std::string &courseId, Course &course);
+
+        // Counts the courses with an ID less than an ID, reading at most one block.
+        // Parameters:
+        //   courseId - The course ID to rank, need not be in the file.
+        //   rank     - Receives the number of smaller IDs, the ID's position when
+        //              it is present.
+        //   Returns: True if counted, false if the block holding the ID is corrupt.
+        bool Rank(const std::string &courseId, uint64_t &rank);
+
+        // Returns the course IDs closest to one that was not found, as
+        // CourseTree::SuggestIds does, by walking the IDs of the file in order.
+        // Only the blocks near the branches the walk follows are read.
+        // Parameters:
+        //   courseId - The mistyped course ID.
+        //   limit    - Most suggestions to return.
+        //   Returns: Suggested IDs, closest first, or none if a block is corrupt.
+        std::vector<std::string> SuggestIds(const std::string &courseId, size_t limit = 5);
+
+        // Returns copies of a run of courses in ID order, reading only its blocks.
+        // Parameters:
+        //   first - Zero-based position of the first course.
+        //   count - Most courses to return.
+        std::vector<Course> GetCoursesInRange(uint64_t first, uint64_t count);
+
+        // Prints all courses in sorted order, streaming every block past the cache
+        // so a full listing does not evict the blocks lookups are using.
+        void PrintOrdered();
+
+        // Prints details of a single course by ID, or "Course not found." and any
+        // suggested IDs.
+        // Parameters:
+        //   courseId - The course ID to print.
+        void PrintSingleCourse(std::string courseId);
+
+        // Prints the ID and name of the courses on one page of the ordered list.
+        // Parameters:
+        //   page     - One-based page number.
+        //   pageSize - Courses per page.
+        void PrintPage(int page, int pageSize);
+
+        // Returns the cache and I/O counters.
+        BlockCacheStats GetCacheStats();
+
+        // Resets the cache and I/O counters to zero. Cached blocks are kept.
+        void ResetCacheStats();
+
+        // Prints the sparse index size, cache hit rate and bytes read per query.
+        void PrintCacheStats();
+    };
+
+} // namespace BST
@@ -0,0 +1,164 @@
+//============================================================================
+// Name        : CatalogEmbed.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Command-line tool that loads and validates a course file and
+//               writes it as EmbeddedCourses.hpp, a header of constexpr course
+//               records for builds of the ABCU Course App with a compiled-in
+//               catalog (ABCU_EMBEDDED_CATALOG).
+//============================================================================
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BST.hpp"
+#include "CourseLoader.hpp"
+
+using namespace BST;
+
+// Writes text as a C++ string literal. Quotes, backslashes and anything outside
+// printable ASCII are written as escapes; octal escapes are used because they
+// stop after three digits, unlike hex escapes.
+// Parameters:
+//   out  - Stream to write to.
+//   text - The text to quote.
+void WriteLiteral(std::ostream &out, const std::string &text)
+{
+    out << '"';
+    for (char c : text)
+    {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\')
+        {
+            out << '\\' << c;
+        }
+        else if (byte < 0x20 || byte > 0x7e)
+        {
+            char escape[8];
+            std::snprintf(escape, sizeof(escape), "\\%03o", byte);
+            out << escape;
+        }
+        else
+        {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+// Writes a validated catalog as a header of constexpr records.
+// Parameters:
+//   filePath   - Path of the header to write.
+//   sourcePath - Course file the catalog came from, named in the header.
+//   courses    - Every course, sorted by case-insensitive ID.
+// Returns: True if the header was written, false if a prerequisite did not
+//          resolve or the file could not be written.
+bool WriteEmbeddedHeader(const std::string &filePath, const std::string &sourcePath, const std::vector<Course> &courses)
+{
+    NoCaseCompare compare;
+    std::vector<uint32_t> edges;
+    std::vector<uint32_t> firstEdges;
+    firstEdges.reserve(courses.size());
+    for (const Course &course : courses)
+    {
+        firstEdges.push_back(static_cast<uint32_t>(edges.size()));
+        for (const std::string &prereq : course.prereqs)
+        {
+            auto found = std::lower_bound(courses.begin(), courses.end(), prereq,
+                                          [&compare](const Course &candidate, const std::string &id)
+                                          { return compare(candidate.courseId, id) < 0; });
+            if (found == courses.end() || compare(found->courseId, prereq) != 0)
+            {
+                std::cerr << "Unknown prerequisite: " << prereq << std::endl;
+                return false;
+            }
+            edges.push_back(static_cast<uint32_t>(found - courses.begin()));
+        }
+    }
+
+    std::ofstream out(filePath, std::ios::trunc);
+    out << "// Generated by CatalogEmbed from " << sourcePath << ". Do not edit, run CatalogEmbed again." << std::endl;
+    out << "#pragma once" << std::endl;
+    out << std::endl;
+    out << "#include <cstdint>" << std::endl;
+    out << "#include \"EmbeddedCatalog.hpp\"" << std::endl;
+    out << std::endl;
+    out << "namespace BST" << std::endl;
+    out << "{" << std::endl;
+    out << "    inline constexpr EmbeddedCourse EMBEDDED_COURSES[] = {" << std::endl;
+    for (size_t i = 0; i < courses.size(); i++)
+    {
+        out << "        {";
+        WriteLiteral(out, courses[i].courseId);
+        out << ", ";
+        WriteLiteral(out, courses[i].courseName);
+        out << ", " << firstEdges[i] << ", " << courses[i].prereqs.size() << "}," << std::endl;
+    }
+    out << "    };" << std::endl;
+    out << "    inline constexpr uint32_t EMBEDDED_COURSE_COUNT = " << courses.size() << ";" << std::endl;
+    out << std::endl;
+    out << "    // Record index of every prerequisite edge, followed by an unused 0 so the array is never empty." << std::endl;
+    out << "    inline constexpr uint32_t EMBEDDED_PREREQS[] = {";
+    for (size_t i = 0; i < edges.size(); i++)
+    {
+        out << (i % 16 == 0 ? "\n        " : " ") << edges[i] << ",";
+    }
+    out << "\n        0};" << std::endl;
+    out << "    inline constexpr uint32_t EMBEDDED_PREREQ_COUNT = " << edges.size() << ";" << std::endl;
+    out << "} // namespace BST" << std::endl;
+    return out.good();
+}
+
+// Generator entry point.
+// Parameters:
+//   argv - --file FILE for the course file and --out FILE for the header.
+// Returns: 0 on success, 1 if the catalog is invalid or a file cannot be used.
+int main(int argc, char *argv[])
+{
+    std::string sourcePath = "CourseList.txt";
+    std::string filePath = "EmbeddedCourses.hpp";
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string flag = argv[i];
+        if (flag == "--file")
+        {
+            sourcePath = argv[i + 1];
+        }
+        else if (flag == "--out")
+        {
+            filePath = argv[i + 1];
+        }
+        else
+        {
+            std::cerr << "Unknown flag: " << flag << std::endl;
+            std::cerr << "Usage: CatalogEmbed [--file CourseList.txt] [--out EmbeddedCourses.hpp]" << std::endl;
+            return 1;
+        }
+    }
+    if (argc % 2 == 0)
+    {
+        std::cerr << "Missing value for " << argv[argc - 1] << std::endl;
+        return 1;
+    }
+
+    // Load and validate exactly as the app does, so only a catalog the app would
+    // accept is compiled in.
+    CourseTree tree;
+    if (!ReadCourseFileParallel(sourcePath, &tree, 0) || tree.GetSize() == 0)
+    {
+        std::cerr << "Catalog not embedded, " << sourcePath << " is missing, empty or invalid." << std::endl;
+        return 1;
+    }
+    std::vector<Course> courses = tree.GetCoursesInOrder();
+    if (!WriteEmbeddedHeader(filePath, sourcePath, courses))
+    {
+        std::cerr << "Failed to write " << filePath << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << courses.size() << " courses to " << filePath << std::endl;
+    return 0;
+}
@@ -0,0 +1,50 @@
+//============================================================================
+// Name        : CatalogGen.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Command-line tool that writes a synthetic course catalog for
+//               testing and benchmarking the ABCU Course App.
+//============================================================================
+
+#include <iostream>
+#include <string>
+#include "CatalogGenerator.hpp"
+
+// Generator entry point.
+// Parameters:
+//   argv - Generator flags (see ApplyGeneratorFlag) and --out FILE.
+// Returns: 0 on success, 1 on a bad flag or write failure.
+int main(int argc, char *argv[])
+{
+    GeneratorOptions options;
+    std::string filePath = "GeneratedCatalog.txt";
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string flag = argv[i];
+        if (flag == "--out")
+        {
+            filePath = argv[i + 1];
+        }
+        else if (!ApplyGeneratorFlag(flag, argv[i + 1], options))
+        {
+            std::cerr << "Unknown flag or bad value: " << flag << " " << argv[i + 1] << std::endl;
+            std::cerr << "Usage: CatalogGen [--courses N] [--order sorted|random|reverse] [--id-length MIN-MAX]" << std::endl;
+            std::cerr << "                  [--name-length MIN-MAX] [--fanout N] [--depth N] [--seed N] [--out FILE]" << std::endl;
+            return 1;
+        }
+    }
+    if (argc % 2 == 0)
+    {
+        std::cerr << "Missing value for " << argv[argc - 1] << std::endl;
+        return 1;
+    }
+
+    if (!WriteCatalogFile(filePath, GenerateCatalog(options)))
+    {
+        std::cerr << "Failed to write " << filePath << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << options.courseCount << " courses to " << filePath << std::endl;
+    return 0;
+}
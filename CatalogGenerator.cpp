@@ -0,0 +1,215 @@
+//============================================================================
+// Name        : CatalogGenerator.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Implementation file for the synthetic course catalog generator
+//               used by the benchmarks and the CatalogGen tool.
+//============================================================================
+
+#include "CatalogGenerator.hpp"
+#include <algorithm>
+#include <fstream>
+#include <random>
+
+using namespace BST;
+
+// Builds a unique course ID of roughly the requested length: uppercase letters
+// followed by digits, e.g. index 1234 at length 7 -> "AAAB234".
+// Parameters:
+//   index  - Unique number of the course.
+//   length - Requested length (at least 5).
+// Returns: Course ID string.
+static std::string MakeCourseId(size_t index, size_t length)
+{
+    size_t digits = std::max<size_t>(length, 5) - 4;
+    size_t modulus = 1;
+    for (size_t i = 0; i < digits; i++)
+    {
+        modulus *= 10;
+    }
+
+    std::string letters;
+    size_t prefix = index / modulus;
+    while (letters.size() < 4 || prefix > 0)
+    {
+        letters.insert(letters.begin(), static_cast<char>('A' + prefix % 26));
+        prefix /= 26;
+    }
+
+    std::string number = std::to_string(index % modulus);
+    return letters + std::string(digits - number.size(), '0') + number;
+}
+
+// Generates a catalog.
+// Parameters:
+//   options - Settings for the catalog.
+// Returns: The courses in the requested order.
+std::vector<Course> GenerateCatalog(const GeneratorOptions &options)
+{
+    std::mt19937_64 random(options.seed);
+    auto between = [&random](size_t low, size_t high)
+    {
+        return high <= low ? low : low + random() % (high - low + 1);
+    };
+
+    size_t count = options.courseCount;
+    size_t depth = std::max<size_t>(options.maxDepth, 1);
+    std::vector<Course> courses(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        courses[i].courseId = MakeCourseId(i, between(options.minIdLength, options.maxIdLength));
+
+        std::string name = "Course " + std::to_string(i);
+        size_t nameLength = between(options.minNameLength, options.maxNameLength);
+        while (name.size() < nameLength)
+        {
+            name += static_cast<char>('a' + random() % 26);
+        }
+        name.resize(nameLength);
+        courses[i].courseName = name;
+    }
+
+    // Course i sits on level i % depth and takes prerequisites from the level below.
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t level = i % depth;
+        if (level == 0)
+        {
+            continue;
+        }
+        size_t candidates = (count - level + depth) / depth; // Courses on the level below.
+        size_t fanOut = between(0, options.maxFanOut);
+        for (size_t p = 0; p < fanOut; p++)
+        {
+            size_t prereq = (level - 1) + depth * (random() % candidates);
+            const std::string &prereqId = courses[prereq].courseId;
+            std::vector<std::string> &prereqs = courses[i].prereqs;
+            if (std::find(prereqs.begin(), prereqs.end(), prereqId) == prereqs.end())
+            {
+                prereqs.push_back(prereqId);
+            }
+        }
+    }
+
+    auto lessNoCase = [](const Course &first, const Course &second)
+    {
+        return std::lexicographical_compare(first.courseId.begin(), first.courseId.end(),
+                                            second.courseId.begin(), second.courseId.end(),
+                                            [](char a, char b)
+                                            { return ::tolower(a) < ::tolower(b); });
+    };
+    switch (options.order)
+    {
+    case KeyOrder::Sorted:
+        std::sort(courses.begin(), courses.end(), lessNoCase);
+        break;
+    case KeyOrder::Reverse:
+        std::sort(courses.begin(), courses.end(), lessNoCase);
+        std::reverse(courses.begin(), courses.end());
+        break;
+    case KeyOrder::Random:
+        std::shuffle(courses.begin(), courses.end(), random);
+        break;
+    }
+    return courses;
+}
+
+// Writes courses in the comma-separated format read by the course loaders.
+// Parameters:
+//   filePath - Path of the file to write.
+//   courses  - Courses to write, in file order.
+// Returns: True if the file was written.
+bool WriteCatalogFile(const std::string &filePath, const std::vector<Course> &courses)
+{
+    std::ofstream out(filePath, std::ios::trunc);
+    for (const Course &course : courses)
+    {
+        out << course.courseId << "," << course.courseName;
+        for (const std::string &prereq : course.prereqs)
+        {
+            out << "," << prereq;
+        }
+        out << "\n";
+    }
+    return out.good();
+}
+
+// Parses "MIN-MAX" (or a single number for both) into a range.
+static bool ParseRange(const std::string &value, size_t &low, size_t &high)
+{
+    size_t dash = value.find('-');
+    low = std::stoul(value.substr(0, dash));
+    high = dash == std::string::npos ? low : std::stoul(value.substr(dash + 1));
+    return low <= high;
+}
+
+// Applies one command-line flag to the generator settings.
+// Parameters:
+//   flag    - The flag, including its leading dashes.
+//   value   - The value following the flag.
+//   options - Reference to the settings to update.
+// Returns: True if the flag was recognized and its value is valid.
+bool ApplyGeneratorFlag(const std::string &flag, const std::string &value, GeneratorOptions &options)
+{
+    try
+    {
+        if (flag == "--courses")
+        {
+            options.courseCount = std::stoul(value);
+        }
+        else if (flag == "--order")
+        {
+            if (value == "sorted")
+                options.order = KeyOrder::Sorted;
+            else if (value == "random")
+                options.order = KeyOrder::Random;
+            else if (value == "reverse")
+                options.order = KeyOrder::Reverse;
+            else
+                return false;
+        }
+        else if (flag == "--id-length")
+        {
+            return ParseRange(value, options.minIdLength, options.maxIdLength);
+        }
+        else if (flag == "--name-length")
+        {
+            return ParseRange(value, options.minNameLength, options.maxNameLength);
+        }
+        else if (flag == "--fanout")
+        {
+            options.maxFanOut = std::stoul(value);
+        }
+        else if (flag == "--depth")
+        {
+            options.maxDepth = std::stoul(value);
+        }
+        else if (flag == "--seed")
+        {
+            options.seed = std::stoull(value);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        return false;
+    }
+    return true;
+}
+
+// Returns the name of a key order, as accepted by --order.
+std::string KeyOrderName(KeyOrder order)
+{
+    switch (order)
+    {
+    case KeyOrder::Sorted:
+        return "sorted";
+    case KeyOrder::Reverse:
+        return "reverse";
+    default:
+        return "random";
+    }
+}
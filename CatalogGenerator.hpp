@@ -0,0 +1,63 @@
+//============================================================================
+// Name        : CatalogGenerator.hpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Header file for the synthetic course catalog generator used by
+//               the benchmarks and the CatalogGen tool. Catalogs can vary in
+//               size, key order, ID and name lengths and prerequisite shape.
+//============================================================================
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BST.hpp"
+
+// Order in which generated courses are written.
+enum class KeyOrder
+{
+    Sorted,  // Ascending by course ID, the worst case for unbalanced insertion.
+    Random,  // Shuffled.
+    Reverse  // Descending by course ID.
+};
+
+// Settings for a generated catalog.
+struct GeneratorOptions
+{
+    size_t courseCount = 10000;      // Number of courses.
+    KeyOrder order = KeyOrder::Random; // Order of the lines in the file.
+    size_t minIdLength = 7;          // Shortest course ID (7 passes validation).
+    size_t maxIdLength = 7;          // Longest course ID.
+    size_t minNameLength = 8;        // Shortest course name (3 to 40 passes validation).
+    size_t maxNameLength = 30;       // Longest course name.
+    size_t maxFanOut = 3;            // Most prerequisites a course can have.
+    size_t maxDepth = 5;             // Longest chain of prerequisites.
+    uint64_t seed = 42;              // Random seed, equal seeds give equal catalogs.
+};
+
+// Generates a catalog. Courses are split into maxDepth levels and every prerequisite
+// comes from the level below, so all prerequisites exist and chains reach maxDepth.
+// Parameters:
+//   options - Settings for the catalog.
+// Returns: The courses in the requested order.
+std::vector<BST::Course> GenerateCatalog(const GeneratorOptions &options);
+
+// Writes courses in the comma-separated format read by the course loaders.
+// Parameters:
+//   filePath - Path of the file to write.
+//   courses  - Courses to write, in file order.
+// Returns: True if the file was written.
+bool WriteCatalogFile(const std::string &filePath, const std::vector<BST::Course> &courses);
+
+// Applies one command-line flag to the generator settings. Recognized flags are
+// --courses N, --order sorted|random|reverse, --id-length MIN-MAX,
+// --name-length MIN-MAX, --fanout N, --depth N and --seed N.
+// Parameters:
+//   flag    - The flag, including its leading dashes.
+//   value   - The value following the flag.
+//   options - Reference to the settings to update.
+// Returns: True if the flag was recognized and its value is valid.
+bool ApplyGeneratorFlag(const std::string &flag, const std::string &value, GeneratorOptions &options);
+
+// Returns the name of a key order, as accepted by --order.
+std::string KeyOrderName(KeyOrder order);
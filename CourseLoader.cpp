@@ -0,0 +1,469 @@
+//============================================================================
+// Name        : CourseLoader.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Implementation file for the course file loaders used by the ABCU
+//               Course App. The serial loader inserts the next 100 lines of a
+//               file one at a time, the parallel loader splits the whole file
+//               across worker threads and builds the tree balanced in one pass,
+//               and delta files add, remove and modify courses in place.
+//============================================================================
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <filesystem>
+#include "CourseLoader.hpp"
+#include "Latency.hpp"
+
+using namespace BST;
+
+namespace
+{
+    // A parsed line of the course file waiting to be merged into the tree.
+    struct ParsedCourse
+    {
+        std::string key; // Lowercase course ID, the order used by the tree.
+        size_t line;     // Line number in the file, the first line wins a duplicate.
+        Course course;   // Parsed course data.
+    };
+
+    // Orders parsed courses by ID and then by line so that the first occurrence
+    // of a duplicate ID is the one kept, as with serial insertion.
+    bool ParsedLess(const ParsedCourse &first, const ParsedCourse &second)
+    {
+        int result = first.key.compare(second.key);
+        return result < 0 || (result == 0 && first.line < second.line);
+    }
+
+    // Runs job(i) for i in [0, count) with one thread each and waits for all of them.
+    template <typename Job>
+    void RunOnThreads(size_t count, Job job)
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            workers.emplace_back(job, i);
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    // Reads a whole course file into memory, reporting a missing or unreadable file.
+    // Parameters:
+    //   filePath - The path to the file.
+    //   buffer   - Receives the file contents.
+    // Returns: True if the file was read.
+    bool ReadWholeFile(const std::string &filePath, std::string &buffer)
+    {
+        if (!std::filesystem::exists(filePath))
+        {
+            std::cerr << "Error, File doesn't exist." << std::endl;
+            return false;
+        }
+
+        try
+        {
+            std::ifstream readfile(filePath, std::ios::binary);
+
+            // Check for file opening failure.
+            if (readfile.fail())
+            {
+                std::cout << std::endl;
+                std::cout << "            Failure to open a file of this name, please" << std::endl;
+                std::cout << "            make sure the file exists in programs directory." << std::endl;
+                std::cout << std::endl;
+                return false;
+            }
+
+            std::ostringstream contents;
+            contents << readfile.rdbuf();
+            buffer = contents.str();
+        }
+        catch (std::ifstream::failure &e)
+        {
+            // Handle file reading errors.
+            std::cerr << "            Error opening/reading file." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Splits a file into chunks that each start at the beginning of a line.
+    // Parameters:
+    //   buffer     - The file contents.
+    //   chunkCount - Number of chunks.
+    // Returns: chunkCount + 1 offsets, chunk t spans [bounds[t], bounds[t + 1]).
+    std::vector<size_t> LineChunkBounds(const std::string &buffer, size_t chunkCount)
+    {
+        std::vector<size_t> bounds(chunkCount + 1, buffer.size());
+        bounds[0] = 0;
+        for (size_t t = 1; t < chunkCount; t++)
+        {
+            size_t pos = std::max(bounds[t - 1], buffer.size() * t / chunkCount);
+            if (pos > 0 && pos < buffer.size())
+            {
+                size_t newline = buffer.find('\n', pos - 1);
+                pos = newline == std::string::npos ? buffer.size() : newline + 1;
+            }
+            bounds[t] = pos;
+        }
+        return bounds;
+    }
+}
+
+// Splits one line of a course file into a Course. Matches std::getline with a comma
+// delimiter: empty pieces between commas are kept, a trailing empty piece is not.
+// Each piece is copied once, straight from the line into its place in the course.
+// A trailing '\r' is dropped, so files with Windows line endings parse the same
+// whichever loader reads them.
+// Parameters:
+//   line   - The line of text to parse (without its newline).
+//   course - Reference to the Course object to fill.
+void ParseCourseLine(std::string_view line, Course &course)
+{
+    if (!line.empty() && line.back() == '\r')
+    {
+        line.remove_suffix(1);
+    }
+
+    std::string_view firstPiece;
+    size_t pieceCount = 0;
+    size_t start = 0;
+    while (start < line.size())
+    {
+        size_t comma = line.find(',', start);
+        if (comma == std::string_view::npos)
+        {
+            comma = line.size();
+        }
+        std::string_view piece = line.substr(start, comma - start);
+        if (pieceCount == 0)
+        {
+            firstPiece = piece; // Only an ID if a name follows it.
+        }
+        else if (pieceCount == 1)
+        {
+            course.courseId.assign(firstPiece);
+            course.courseName.assign(piece);
+        }
+        else
+        {
+            course.prereqs.emplace_back(piece);
+        }
+        pieceCount++;
+        start = comma + 1;
+    }
+}
+
+// Reads course data from a file and populates the Binary Search Tree.
+// Parameters:
+//   filepath      - The path to the file containing course data.
+//   tree          - Pointer to the CourseTree to store the course data.
+// Returns: True if the file was successfully read and the tree was populated, false otherwise.
+bool ReadCourseFile(std::string filePath, CourseTree *tree)
+{
+    ScopedLatency timer(LatencyOperation::ReadCourseFile);
+
+    if (!std::filesystem::exists(filePath))
+    {
+        std::cerr << "Error, File doesn't exist." << std::endl;
+        return false;
+    }
+
+    try
+    {
+        std::ifstream readfile(filePath);
+        std::string line;
+
+        // Check for file opening failure.
+        if (readfile.fail())
+        {
+            std::cout << std::endl;
+            std::cout << "            Failure to open a file of this name, please" << std::endl;
+            std::cout << "            make sure the file exists in programs directory." << std::endl;
+            std::cout << std::endl;
+            return false;
+        }
+
+        // Get next 100 courses
+
+        int starting = tree->GetSize();
+        int index = 0;
+        int ending = starting + 100;
+
+        // Read file line by line.
+        while (getline(readfile, line))
+        {
+            if (index >= starting && index < ending)
+            {
+                // Parse the line and move the course into its node.
+                Course course;
+                ParseCourseLine(line, course);
+
+                // Insert course into the tree, a rejected course is left untouched.
+                bool success = tree->Insert(std::move(course));
+                if (!success)
+                {
+                    std::cout << "Not inserted: " << course.courseId << std::endl;
+                }
+            }
+
+            index++;
+        }
+    }
+    catch (std::ifstream::failure &e)
+    {
+        // Handle file reading errors.
+        std::cerr << "            Error opening/reading file." << std::endl;
+        return false;
+    }
+
+    // Validate all courses in the tree.
+    bool valid = tree->ValidateCourses();
+    return valid;
+}
+
+// Reads an entire course file on several threads and replaces the contents of the tree.
+// Parameters:
+//   filepath    - The path to the file containing course data.
+//   tree        - Pointer to the CourseTree to store the course data.
+//   threadCount - Number of worker threads, 0 to use every hardware thread.
+// Returns: True if the file was successfully read and the tree was populated, false otherwise.
+bool ReadCourseFileParallel(std::string filePath, CourseTree *tree, unsigned int threadCount)
+{
+    ScopedLatency timer(LatencyOperation::ReadCourseFile);
+
+    std::string buffer;
+    if (!ReadWholeFile(filePath, buffer))
+    {
+        return false;
+    }
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Split the file into chunks that each start at the beginning of a line.
+    std::vector<size_t> bounds = LineChunkBounds(buffer, threadCount);
+
+    // Parse every chunk into its own batch. Line numbers are local for now.
+    std::vector<std::vector<ParsedCourse>> batches(threadCount);
+    RunOnThreads(threadCount, [&](size_t t)
+                 {
+        size_t pos = bounds[t];
+        size_t end = bounds[t + 1];
+        size_t line = 0;
+        while (pos < end)
+        {
+            size_t newline = buffer.find('\n', pos);
+            if (newline == std::string::npos || newline > end)
+            {
+                newline = end;
+            }
+            ParsedCourse parsed;
+            parsed.line = line++;
+            ParseCourseLine(std::string_view(buffer).substr(pos, newline - pos), parsed.course);
+            parsed.key = parsed.course.courseId;
+            std::transform(parsed.key.begin(), parsed.key.end(), parsed.key.begin(), ::tolower);
+            batches[t].push_back(std::move(parsed));
+            pos = newline + 1;
+        } });
+
+    // Turn local line numbers into file line numbers and sort each batch.
+    std::vector<size_t> offsets(threadCount + 1, 0);
+    for (size_t t = 0; t < threadCount; t++)
+    {
+        offsets[t + 1] = offsets[t] + batches[t].size();
+    }
+    RunOnThreads(threadCount, [&](size_t t)
+                 {
+        for (ParsedCourse &parsed : batches[t])
+        {
+            parsed.line += offsets[t];
+        }
+        std::sort(batches[t].begin(), batches[t].end(), ParsedLess); });
+
+    // Gather the sorted batches and merge neighbouring runs in parallel until one remains.
+    std::vector<ParsedCourse> all(offsets[threadCount]);
+    RunOnThreads(threadCount, [&](size_t t)
+                 { std::move(batches[t].begin(), batches[t].end(), all.begin() + offsets[t]); });
+    batches.clear();
+
+    std::vector<size_t> runs = offsets;
+    while (runs.size() > 2)
+    {
+        size_t pairs = (runs.size() - 1) / 2;
+        RunOnThreads(pairs, [&](size_t p)
+                     { std::inplace_merge(all.begin() + runs[2 * p], all.begin() + runs[2 * p + 1],
+                                          all.begin() + runs[2 * p + 2], ParsedLess); });
+        std::vector<size_t> merged;
+        for (size_t i = 0; i < runs.size(); i += 2)
+        {
+            merged.push_back(runs[i]);
+        }
+        if (merged.back() != runs.back())
+        {
+            merged.push_back(runs.back());
+        }
+        runs = merged;
+    }
+
+    // Keep the first occurrence of each ID and report the rest in file order.
+    std::vector<Course> courses;
+    std::vector<std::pair<size_t, std::string>> duplicates;
+    courses.reserve(all.size());
+    for (size_t i = 0; i < all.size(); i++)
+    {
+        if (i > 0 && all[i].key == all[i - 1].key)
+        {
+            duplicates.emplace_back(all[i].line, all[i].course.courseId);
+        }
+        else
+        {
+            courses.push_back(std::move(all[i].course));
+        }
+    }
+    all.clear();
+
+    std::sort(duplicates.begin(), duplicates.end());
+    for (const auto &[line, courseId] : duplicates)
+    {
+        std::cout << "Not inserted: " << courseId << std::endl;
+    }
+
+    tree->BuildFromSorted(std::move(courses));
+
+    // Validate all courses in the tree.
+    bool valid = tree->ValidateCourses();
+    return valid;
+}
+
+// Reads an entire course file on several threads into a department-sharded catalog.
+// Parameters:
+//   filepath    - The path to the file containing course data.
+//   catalog     - Pointer to the ShardedCatalog to replace.
+//   threadCount - Number of worker threads, 0 to use every hardware thread.
+// Returns: True if the file was successfully read and every course is valid, false otherwise.
+bool ReadCourseFileSharded(std::string filePath, ShardedCatalog *catalog, unsigned int threadCount)
+{
+    ScopedLatency timer(LatencyOperation::ReadCourseFile);
+
+    std::string buffer;
+    if (!ReadWholeFile(filePath, buffer))
+    {
+        return false;
+    }
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Parse every chunk into its own batch; the catalog splits them by department.
+    std::vector<size_t> bounds = LineChunkBounds(buffer, threadCount);
+    std::vector<std::vector<Course>> batches(threadCount);
+    RunOnThreads(threadCount, [&](size_t t)
+                 {
+        size_t pos = bounds[t];
+        size_t end = bounds[t + 1];
+        while (pos < end)
+        {
+            size_t newline = buffer.find('\n', pos);
+            if (newline == std::string::npos || newline > end)
+            {
+                newline = end;
+            }
+            batches[t].emplace_back();
+            ParseCourseLine(std::string_view(buffer).substr(pos, newline - pos), batches[t].back());
+            pos = newline + 1;
+        } });
+
+    return catalog->Build(std::move(batches), threadCount);
+}
+
+// Reads a delta file and applies it to a loaded catalog as one unit.
+// Parameters:
+//   filepath - The path to the delta file.
+//   tree     - Pointer to the CourseTree to change.
+// Returns: True if every change was applied, false if the tree was left unchanged.
+bool ApplyDeltaFile(std::string filePath, CourseTree *tree)
+{
+    if (!std::filesystem::exists(filePath))
+    {
+        std::cerr << "Error, File doesn't exist." << std::endl;
+        return false;
+    }
+
+    std::vector<CourseChange> changes;
+    try
+    {
+        std::ifstream readfile(filePath);
+        std::string line;
+
+        // Check for file opening failure.
+        if (readfile.fail())
+        {
+            std::cout << std::endl;
+            std::cout << "            Failure to open a file of this name, please" << std::endl;
+            std::cout << "            make sure the file exists in programs directory." << std::endl;
+            std::cout << std::endl;
+            return false;
+        }
+
+        // Parse every line before changing anything.
+        size_t lineNumber = 0;
+        while (getline(readfile, line))
+        {
+            lineNumber++;
+            std::string_view text(line);
+            if (!text.empty() && text.back() == '\r')
+            {
+                text.remove_suffix(1);
+            }
+            if (text.empty())
+            {
+                continue;
+            }
+            size_t comma = text.find(',');
+            std::string action(text.substr(0, comma));
+            std::transform(action.begin(), action.end(), action.begin(), ::tolower);
+            std::string_view rest = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+
+            CourseChange change{CourseChange::Kind::Add, Course()};
+            if (action == "remove")
+            {
+                change.kind = CourseChange::Kind::Remove;
+                change.course.courseId.assign(rest.substr(0, rest.find(',')));
+            }
+            else if (action == "add" || action == "modify")
+            {
+                change.kind = action == "add" ? CourseChange::Kind::Add : CourseChange::Kind::Modify;
+                ParseCourseLine(rest, change.course);
+            }
+            if (change.course.courseId.empty())
+            {
+                std::cout << "Bad delta line " << lineNumber << ": " << line << std::endl;
+                return false;
+            }
+            changes.push_back(std::move(change));
+        }
+    }
+    catch (std::ifstream::failure &e)
+    {
+        // Handle file reading errors.
+        std::cerr << "            Error opening/reading file." << std::endl;
+        return false;
+    }
+
+    return tree->ApplyChanges(std::move(changes));
+}
@@ -0,0 +1,64 @@
+//============================================================================
+// Name        : CourseLoader.hpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Header file for the course file loaders used by the ABCU Course
+//               App. Declares the line parser shared by every loader, the serial
+//               loader that reads the next 100 courses, the multi-threaded
+//               loader that builds the whole catalog at once, the sharded loader
+//               that builds one tree per department, and the reader for
+//               delta files that change a loaded catalog.
+//============================================================================
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "BST.hpp"
+#include "ShardedCatalog.hpp"
+
+// Splits one line of a course file into a Course. Pieces are separated by commas,
+// the first two are the ID and name and any others are prerequisite IDs.
+// Parameters:
+//   line   - The line of text to parse (without its newline, a trailing '\r' is ignored).
+//   course - Reference to the Course object to fill.
+void ParseCourseLine(std::string_view line, BST::Course &course);
+
+// Reads course data from a file and populates the Binary Search Tree.
+// Parameters:
+//   filepath      - The path to the file containing course data.
+//   dataStructure - Pointer to the CourseTree to store the course data.
+// Returns: True if the file was successfully read and the tree was populated, false otherwise.
+bool ReadCourseFile(std::string filepath, BST::CourseTree *courseTree);
+
+// Reads an entire course file on several threads and replaces the contents of the
+// Binary Search Tree with it. The file is split into newline-aligned chunks that are
+// parsed and sorted on worker threads, merged in parallel and built balanced.
+// Duplicate and validation errors are reported exactly as ReadCourseFile does.
+// Parameters:
+//   filepath    - The path to the file containing course data.
+//   courseTree  - Pointer to the CourseTree to store the course data.
+//   threadCount - Number of worker threads, 0 to use every hardware thread.
+// Returns: True if the file was successfully read and the tree was populated, false otherwise.
+bool ReadCourseFileParallel(std::string filepath, BST::CourseTree *courseTree, unsigned int threadCount);
+
+// Reads an entire course file on several threads into a department-sharded catalog,
+// replacing its contents. Chunks of the file are parsed in parallel, then the
+// catalog builds and validates its shards in parallel. Duplicate and validation
+// errors are reported as ReadCourseFile does.
+// Parameters:
+//   filepath    - The path to the file containing course data.
+//   catalog     - Pointer to the ShardedCatalog to replace.
+//   threadCount - Number of worker threads, 0 to use every hardware thread.
+// Returns: True if the file was successfully read and every course is valid, false otherwise.
+bool ReadCourseFileSharded(std::string filepath, BST::ShardedCatalog *catalog, unsigned int threadCount);
+
+// Reads a delta file and applies it to a loaded catalog as one unit. Each line is
+// "add,ID,Name,Prereqs...", "modify,ID,Name,Prereqs..." or "remove,ID"; the action
+// ignores case and blank lines are skipped. Nothing is applied if any line cannot
+// be parsed, and every change is rolled back if one fails or leaves a course invalid.
+// Parameters:
+//   filepath   - The path to the delta file.
+//   courseTree - Pointer to the CourseTree to change.
+// Returns: True if every change was applied, false if the tree was left unchanged.
+bool ApplyDeltaFile(std::string filepath, BST::CourseTree *courseTree);
@@ -0,0 +1,174 @@
+//============================================================================
+// Name        : EmbeddedCatalog.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Implementation file for the compiled-in catalog of the ABCU
+//               Course App. Lookups and listings read the constexpr records
+//               directly and print them without building Course objects.
+//============================================================================
+
+#include <iostream>
+#include "EmbeddedCatalog.hpp"
+
+#ifdef ABCU_EMBEDDED_CATALOG
+#include "EmbeddedCourses.hpp"
+
+namespace BST
+{
+    // A catalog that fails validation does not compile, so startup can skip it.
+    static_assert(IsValidEmbeddedCatalog(EMBEDDED_COURSES, EMBEDDED_COURSE_COUNT,
+                                         EMBEDDED_PREREQS, EMBEDDED_PREREQ_COUNT),
+                  "EmbeddedCourses.hpp is not a sorted, valid catalog, run CatalogEmbed again");
+}
+#endif
+
+namespace BST
+{
+
+    // Constructor: Initializes a closed catalog.
+    EmbeddedCatalog::EmbeddedCatalog()
+    {
+        this->courses = nullptr;
+        this->prereqs = nullptr;
+        this->courseCount = 0;
+    }
+
+    // Returns true if the program was built with a compiled-in catalog.
+    bool EmbeddedCatalog::IsBuiltIn()
+    {
+#ifdef ABCU_EMBEDDED_CATALOG
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Points the catalog at the compiled-in records. Nothing is read or copied.
+    // Returns: True if the program has a compiled-in catalog.
+    bool EmbeddedCatalog::Open()
+    {
+#ifdef ABCU_EMBEDDED_CATALOG
+        this->courses = EMBEDDED_COURSES;
+        this->prereqs = EMBEDDED_PREREQS;
+        this->courseCount = EMBEDDED_COURSE_COUNT;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Stops serving the compiled-in records.
+    void EmbeddedCatalog::Close()
+    {
+        this->courses = nullptr;
+        this->prereqs = nullptr;
+        this->courseCount = 0;
+    }
+
+    // Returns true while the catalog is open.
+    bool EmbeddedCatalog::IsOpen()
+    {
+        return this->courses != nullptr;
+    }
+
+    // Returns the number of courses, 0 while closed.
+    int EmbeddedCatalog::GetSize()
+    {
+        return static_cast<int>(this->courseCount);
+    }
+
+    // Searches for a course by ID (case-insensitive) with a binary search over
+    // the sorted records.
+    // Parameters:
+    //   courseId - The course ID to search for.
+    // Returns: The course record, or nullptr if there is none.
+    const EmbeddedCourse *EmbeddedCatalog::Find(std::string_view courseId)
+    {
+        NoCaseCompare compare;
+        uint32_t low = 0;
+        uint32_t high = this->courseCount;
+        while (low < high)
+        {
+            uint32_t mid = low + (high - low) / 2;
+            int result = compare(this->courses[mid].courseId, courseId);
+            if (result == 0)
+            {
+                return &this->courses[mid];
+            }
+            if (result < 0)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        return nullptr;
+    }
+
+    // Returns the course IDs closest to one that was not found. The records are
+    // sorted by ID, so the suggestion walk reads them in place.
+    // Parameters:
+    //   courseId - The mistyped course ID.
+    //   limit    - Most suggestions to return.
+    // Returns: Suggested IDs, closest first.
+    std::vector<std::string> EmbeddedCatalog::SuggestIds(std::string_view courseId, size_t limit)
+    {
+        ScopedLatency timer(LatencyOperation::Suggest);
+        std::vector<std::pair<int, size_t>> found = SuggestSortedIds<NoCaseCompare>(
+            this->courseCount, [this](size_t index)
+            { return this->courses[index].courseId; },
+            [](size_t)
+            { return true; },
+            courseId, limit);
+        std::vector<std::string> suggestions;
+        for (const std::pair<int, size_t> &match : found)
+        {
+            suggestions.emplace_back(this->courses[match.second].courseId);
+        }
+        return suggestions;
+    }
+
+    // Prints all courses in sorted order, in the same layout as CourseTree.
+    void EmbeddedCatalog::PrintOrdered()
+    {
+        for (uint32_t i = 0; i < this->courseCount; i++)
+        {
+            std::cout << "------------------------------------------" << std::endl;
+            std::cout << "Course: " << this->courses[i].courseId << "   Description: " << this->courses[i].courseName << std::endl;
+            std::cout << "------------------------------------------" << std::endl;
+        }
+    }
+
+    // Prints details of a single course by ID, in the same layout as CourseTree.
+    // Prerequisites are printed with the spelling of the course they name.
+    // Parameters:
+    //   courseId - The course ID to print.
+    void EmbeddedCatalog::PrintSingleCourse(std::string_view courseId)
+    {
+        const EmbeddedCourse *course = this->Find(courseId);
+        if (course == nullptr)
+        {
+            CourseTree::PrintNotFound(this->SuggestIds(courseId));
+            return;
+        }
+        std::cout << "------------------------------------------" << std::endl;
+        std::cout << course->courseId << "    " << course->courseName << std::endl;
+        std::cout << "Prereqs:   ";
+        for (uint32_t i = 0; i < course->prereqCount; i++)
+        {
+            if (i != 0)
+            {
+                std::cout << "           ";
+            }
+            std::cout << this->courses[this->prereqs[course->firstPrereq + i]].courseId << std::endl;
+        }
+        if (course->prereqCount == 0)
+        {
+            std::cout << "" << std::endl;
+        }
+        std::cout << "------------------------------------------" << std::endl;
+    }
+
+} // namespace BST
@@ -0,0 +1,123 @@
+//============================================================================
+// Name        : EmbeddedCatalog.hpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Header file for the compiled-in catalog of the ABCU Course App.
+//               CatalogEmbed turns a course file into EmbeddedCourses.hpp, a
+//               constexpr array of sorted course records with prerequisites
+//               resolved to record indices. Built with ABCU_EMBEDDED_CATALOG,
+//               the app serves lookups from that array without reading a file,
+//               parsing, allocating or validating anything at startup.
+//============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "BST.hpp"
+
+namespace BST
+{
+
+    // One course of a compiled-in catalog. Records are sorted by case-insensitive ID.
+    struct EmbeddedCourse
+    {
+        std::string_view courseId;   // Course ID as spelled in the course file.
+        std::string_view courseName; // Course name.
+        uint32_t firstPrereq;        // Index of the course's first prerequisite edge.
+        uint32_t prereqCount;        // Number of prerequisite edges belonging to the course.
+    };
+
+    // Checks at compile time what ValidateCourses would check at runtime: IDs in
+    // strictly increasing order, so there are no duplicates, valid ID and name
+    // lengths, and every prerequisite edge naming a course of the catalog.
+    // Parameters:
+    //   courses     - The course records.
+    //   courseCount - Number of course records.
+    //   prereqs     - Record index of every prerequisite edge.
+    //   prereqCount - Number of prerequisite edges.
+    //   Returns: True if the catalog is valid.
+    constexpr bool IsValidEmbeddedCatalog(const EmbeddedCourse *courses, uint32_t courseCount,
+                                          const uint32_t *prereqs, uint32_t prereqCount)
+    {
+        for (uint32_t i = 0; i < courseCount; i++)
+        {
+            const EmbeddedCourse &course = courses[i];
+            if (course.courseId.size() != 7 || course.courseName.size() < 3 || course.courseName.size() > 40)
+            {
+                return false;
+            }
+            if (i > 0 && NoCaseCompare()(courses[i - 1].courseId, course.courseId) >= 0)
+            {
+                return false;
+            }
+            if (course.firstPrereq > prereqCount || course.prereqCount > prereqCount - course.firstPrereq)
+            {
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < prereqCount; i++)
+        {
+            if (prereqs[i] >= courseCount)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Read-only catalog served from the records compiled into the program.
+    class EmbeddedCatalog
+    {
+    private:
+        const EmbeddedCourse *courses; // Course records, sorted by ID.
+        const uint32_t *prereqs;       // Record index of every prerequisite edge.
+        uint32_t courseCount;          // Number of courses, 0 while closed.
+
+    public:
+        // Constructor: Initializes a closed catalog.
+        EmbeddedCatalog();
+
+        // Returns true if the program was built with a compiled-in catalog.
+        static bool IsBuiltIn();
+
+        // Points the catalog at the compiled-in records. Nothing is read or copied.
+        //   Returns: True if the program has a compiled-in catalog.
+        bool Open();
+
+        // Stops serving the compiled-in records.
+        void Close();
+
+        // Returns true while the catalog is open.
+        bool IsOpen();
+
+        // Returns the number of courses, 0 while closed.
+        int GetSize();
+
+        // Searches for a course by ID (case-insensitive) with a binary search.
+        // Parameters:
+        //   courseId - The course ID to search for.
+        //   Returns: The course record, or nullptr if there is none.
+        const EmbeddedCourse *Find(std::string_view courseId);
+
+        // Returns the course IDs closest to one that was not found, as
+        // CourseTree::SuggestIds does, walking the sorted records.
+        // Parameters:
+        //   courseId - The mistyped course ID.
+        //   limit    - Most suggestions to return.
+        //   Returns: Suggested IDs, closest first.
+        std::vector<std::string> SuggestIds(std::string_view courseId, size_t limit = 5);
+
+        // Prints all courses in sorted order.
+        void PrintOrdered();
+
+        // Prints details of a single course by ID, or "Course not found." and any
+        // suggested IDs.
+        // Parameters:
+        //   courseId - The course ID to print.
+        void PrintSingleCourse(std::string_view courseId);
+    };
+
+} // namespace BST
@@ -0,0 +1,226 @@
+//============================================================================
+// Name        : Latency.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Implementation file for the latency histograms of the ABCU
+//               Course App.
+//============================================================================
+
+#include "Latency.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace BST
+{
+
+    // One histogram per operation, shared by every tree in the process.
+    static LatencyHistogram histograms[static_cast<int>(LatencyOperation::Count)];
+
+    // Constructor: Initializes an empty histogram.
+    LatencyHistogram::LatencyHistogram()
+    {
+        this->Reset();
+    }
+
+    // Returns the bucket holding a value.
+    int LatencyHistogram::BucketOf(uint64_t value)
+    {
+        if (value < SUB_BUCKETS)
+        {
+            return static_cast<int>(value);
+        }
+        int exponent = 63;
+        while ((value >> exponent) == 0)
+        {
+            exponent--;
+        }
+        int shift = exponent - 4; // Keep the four bits below the leading one.
+        int mantissa = static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+        return SUB_BUCKETS + shift * SUB_BUCKETS + mantissa;
+    }
+
+    // Returns the largest value that falls in a bucket.
+    uint64_t LatencyHistogram::BucketTop(int bucket)
+    {
+        if (bucket < SUB_BUCKETS)
+        {
+            return static_cast<uint64_t>(bucket);
+        }
+        int shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+        uint64_t mantissa = static_cast<uint64_t>((bucket - SUB_BUCKETS) % SUB_BUCKETS);
+        return ((SUB_BUCKETS + mantissa + 1) << shift) - 1;
+    }
+
+    // Adds one duration to the histogram.
+    // Parameters:
+    //   nanoseconds - The duration to record.
+    void LatencyHistogram::Record(uint64_t nanoseconds)
+    {
+        this->counts[BucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        this->total.fetch_add(1, std::memory_order_relaxed);
+        uint64_t longest = this->max.load(std::memory_order_relaxed);
+        while (nanoseconds > longest &&
+               !this->max.compare_exchange_weak(longest, nanoseconds, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // Returns the number of recorded durations.
+    uint64_t LatencyHistogram::GetCount() const
+    {
+        return this->total.load(std::memory_order_relaxed);
+    }
+
+    // Returns the longest recorded duration in nanoseconds.
+    uint64_t LatencyHistogram::GetMax() const
+    {
+        return this->max.load(std::memory_order_relaxed);
+    }
+
+    // Returns the duration that the given percentage of recordings do not exceed.
+    // Parameters:
+    //   percentile - Percentage between 0 and 100, e.g. 99.9.
+    uint64_t LatencyHistogram::ValueAtPercentile(double percentile) const
+    {
+        uint64_t count = this->GetCount();
+        if (count == 0)
+        {
+            return 0;
+        }
+        uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * count));
+        target = std::max<uint64_t>(target, 1);
+
+        uint64_t seen = 0;
+        for (int bucket = 0; bucket < BUCKET_COUNT; bucket++)
+        {
+            seen += this->counts[bucket].load(std::memory_order_relaxed);
+            if (seen >= target)
+            {
+                return std::min(BucketTop(bucket), this->GetMax());
+            }
+        }
+        return this->GetMax();
+    }
+
+    // Removes all recorded durations.
+    void LatencyHistogram::Reset()
+    {
+        for (std::atomic<uint64_t> &count : this->counts)
+        {
+            count.store(0, std::memory_order_relaxed);
+        }
+        this->total.store(0, std::memory_order_relaxed);
+        this->max.store(0, std::memory_order_relaxed);
+    }
+
+    // Returns the process-wide histogram of an operation.
+    LatencyHistogram &GetLatencyHistogram(LatencyOperation operation)
+    {
+        return histograms[static_cast<int>(operation)];
+    }
+
+    // Returns the display name of an operation.
+    const char *LatencyOperationName(LatencyOperation operation)
+    {
+        switch (operation)
+        {
+        case LatencyOperation::Insert:
+            return "Insert";
+        case LatencyOperation::Lookup:
+            return "Lookup";
+        case LatencyOperation::PrintOrdered:
+            return "PrintOrdered";
+        case LatencyOperation::ValidateCourses:
+            return "ValidateCourses";
+        case LatencyOperation::ReadCourseFile:
+            return "ReadCourseFile";
+        case LatencyOperation::NameSearch:
+            return "NameSearch";
+        case LatencyOperation::Suggest:
+            return "Suggest";
+        case LatencyOperation::Remove:
+            return "Remove";
+        case LatencyOperation::Update:
+            return "Update";
+        case LatencyOperation::Page:
+            return "Page";
+        default:
+            return "Unknown";
+        }
+    }
+
+    // Formats nanoseconds with a readable unit, e.g. 1532 -> "1.53us".
+    static std::string FormatDuration(uint64_t nanoseconds)
+    {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(2);
+        if (nanoseconds < 1000)
+            text << nanoseconds << "ns";
+        else if (nanoseconds < 1000000)
+            text << nanoseconds / 1e3 << "us";
+        else if (nanoseconds < 1000000000)
+            text << nanoseconds / 1e6 << "ms";
+        else
+            text << nanoseconds / 1e9 << "s";
+        return text.str();
+    }
+
+    // Prints p50, p90, p99, p99.9 and max of every operation that has recordings.
+    // Parameters:
+    //   out - Stream to print to.
+    void PrintLatencyReport(std::ostream &out)
+    {
+        out << "------------------------------------------------------------------------" << std::endl;
+        out << std::left << std::setw(17) << "Operation" << std::right << std::setw(9) << "count"
+            << std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99"
+            << std::setw(10) << "p99.9" << std::setw(10) << "max" << std::endl;
+        for (int i = 0; i < static_cast<int>(LatencyOperation::Count); i++)
+        {
+            LatencyOperation operation = static_cast<LatencyOperation>(i);
+            const LatencyHistogram &histogram = GetLatencyHistogram(operation);
+            if (histogram.GetCount() == 0)
+            {
+                continue;
+            }
+            out << std::left << std::setw(17) << LatencyOperationName(operation) << std::right
+                << std::setw(9) << histogram.GetCount()
+                << std::setw(10) << FormatDuration(histogram.ValueAtPercentile(50))
+                << std::setw(10) << FormatDuration(histogram.ValueAtPercentile(90))
+                << std::setw(10) << FormatDuration(histogram.ValueAtPercentile(99))
+                << std::setw(10) << FormatDuration(histogram.ValueAtPercentile(99.9))
+                << std::setw(10) << FormatDuration(histogram.GetMax()) << std::endl;
+        }
+        out << "------------------------------------------------------------------------" << std::endl;
+    }
+
+    // Removes the recordings of every operation.
+    void ResetLatencyHistograms()
+    {
+        for (LatencyHistogram &histogram : histograms)
+        {
+            histogram.Reset();
+        }
+    }
+
+    // ScopedLatency class implementation.
+
+    // Constructor: Starts timing.
+    // Parameters:
+    //   operation - The operation whose histogram receives the duration.
+    ScopedLatency::ScopedLatency(LatencyOperation operation)
+        : operation(operation), start(std::chrono::steady_clock::now())
+    {
+    }
+
+    // Destructor: Stops timing and records the duration.
+    ScopedLatency::~ScopedLatency()
+    {
+        auto elapsed = std::chrono::steady_clock::now() - this->start;
+        GetLatencyHistogram(this->operation)
+            .Record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+} // namespace BST
@@ -0,0 +1,117 @@
+//============================================================================
+// Name        : Latency.hpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Header file for the latency histograms of the ABCU Course App.
+//               Each public tree operation and the file loaders record their
+//               duration into a log-bucketed histogram that can be printed as
+//               a percentile table, so slow outliers are not hidden by averages.
+//============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace BST
+{
+
+    // Operations that have a latency histogram.
+    enum class LatencyOperation
+    {
+        Insert,          // CourseTree::Insert, including any rebalance it triggers.
+        Lookup,          // CourseTree::PrintSingleCourse.
+        PrintOrdered,    // CourseTree::PrintOrdered.
+        ValidateCourses, // CourseTree::ValidateCourses.
+        ReadCourseFile,  // ReadCourseFile and ReadCourseFileParallel.
+        NameSearch,      // CourseTree::SearchNames.
+        Suggest,         // CourseTree::SuggestIds.
+        Remove,          // CourseTree::Remove.
+        Update,          // CourseTree::Update.
+        Page,            // CourseTree::PrintPage.
+        Count            // Number of operations, not an operation itself.
+    };
+
+    // Histogram of durations in nanoseconds. Values below 16 ns get their own bucket;
+    // above that every power of two is split into 16 buckets, so a reported value is
+    // within about 6% of the real one. Recording is a few relaxed atomic operations
+    // and never locks, so it is safe from any thread.
+    class LatencyHistogram
+    {
+    public:
+        static const int SUB_BUCKETS = 16;                              // Buckets per power of two.
+        static const int BUCKET_COUNT = SUB_BUCKETS + 60 * SUB_BUCKETS; // Covers all 64-bit values.
+
+        // Constructor: Initializes an empty histogram.
+        LatencyHistogram();
+
+        // Adds one duration to the histogram.
+        // Parameters:
+        //   nanoseconds - The duration to record.
+        void Record(uint64_t nanoseconds);
+
+        // Returns the number of recorded durations.
+        uint64_t GetCount() const;
+
+        // Returns the longest recorded duration in nanoseconds.
+        uint64_t GetMax() const;
+
+        // Returns the duration that the given percentage of recordings do not exceed,
+        // rounded up to the top of its bucket and capped at the maximum.
+        // Parameters:
+        //   percentile - Percentage between 0 and 100, e.g. 99.9.
+        uint64_t ValueAtPercentile(double percentile) const;
+
+        // Removes all recorded durations.
+        void Reset();
+
+    private:
+        std::atomic<uint64_t> counts[BUCKET_COUNT]; // Recordings per bucket.
+        std::atomic<uint64_t> total;                // Number of recordings.
+        std::atomic<uint64_t> max;                  // Longest recording.
+
+        // Returns the bucket holding a value.
+        static int BucketOf(uint64_t value);
+
+        // Returns the largest value that falls in a bucket.
+        static uint64_t BucketTop(int bucket);
+    };
+
+    // Returns the process-wide histogram of an operation.
+    LatencyHistogram &GetLatencyHistogram(LatencyOperation operation);
+
+    // Returns the display name of an operation.
+    const char *LatencyOperationName(LatencyOperation operation);
+
+    // Prints p50, p90, p99, p99.9 and max of every operation that has recordings.
+    // Parameters:
+    //   out - Stream to print to.
+    void PrintLatencyReport(std::ostream &out);
+
+    // Removes the recordings of every operation.
+    void ResetLatencyHistograms();
+
+    // Records the time from its construction to its destruction into the
+    // histogram of an operation. Place one at the top of a function to time it.
+    class ScopedLatency
+    {
+    public:
+        // Constructor: Starts timing.
+        // Parameters:
+        //   operation - The operation whose histogram receives the duration.
+        explicit ScopedLatency(LatencyOperation operation);
+
+        // Destructor: Stops timing and records the duration.
+        ~ScopedLatency();
+
+        ScopedLatency(const ScopedLatency &) = delete;
+        ScopedLatency &operator=(const ScopedLatency &) = delete;
+
+    private:
+        LatencyOperation operation;                  // Operation being timed.
+        std::chrono::steady_clock::time_point start; // Time the operation began.
+    };
+
+} // namespace BST
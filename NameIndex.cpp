@@ -0,0 +1,321 @@
+//============================================================================
+// Name        : NameIndex.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Implementation file for the trigram course name index of the
+//               ABCU Course App.
+//============================================================================
+
+#include "NameIndex.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace BST
+{
+
+    // Lowercases ASCII letters of a string.
+    // Parameters:
+    //   text - The text to fold.
+    // Returns: The lowercase copy.
+    std::string NameIndex::Fold(std::string_view text)
+    {
+        std::string folded(text);
+        for (char &c : folded)
+        {
+            if (c >= 'A' && c <= 'Z')
+            {
+                c = static_cast<char>(c + ('a' - 'A'));
+            }
+        }
+        return folded;
+    }
+
+    // Packs three characters into a trigram key.
+    // Parameters:
+    //   text - Pointer to the first of the three characters.
+    uint32_t NameIndex::Trigram(const char *text)
+    {
+        return static_cast<uint32_t>(static_cast<unsigned char>(text[0])) |
+               static_cast<uint32_t>(static_cast<unsigned char>(text[1])) << 8 |
+               static_cast<uint32_t>(static_cast<unsigned char>(text[2])) << 16;
+    }
+
+    // Adds a name to the index.
+    // Parameters:
+    //   key  - Key to return when the name matches.
+    //   name - The name to index.
+    void NameIndex::Add(std::string_view key, std::string_view name)
+    {
+        uint32_t entry = static_cast<uint32_t>(this->entries.size());
+        this->entries.push_back(Entry{std::string(key), Fold(name)});
+        if (!this->entryOf.empty())
+        {
+            this->entryOf[this->entries.back().key] = entry;
+        }
+        const std::string &folded = this->entries.back().name;
+        for (size_t i = 0; i + 3 <= folded.size(); i++)
+        {
+            std::vector<uint32_t> &list = this->postings[Trigram(folded.data() + i)];
+            // Entries are added in ascending order, so a repeated trigram is always last.
+            if (list.empty() || list.back() != entry)
+            {
+                list.push_back(entry);
+            }
+        }
+    }
+
+    // Removes a name from the index by marking its entry removed, compacting the
+    // index once removed entries make up more than a quarter of it.
+    // Parameters:
+    //   key - Key the name was added with.
+    // Returns: True if the entry was found and removed.
+    bool NameIndex::Remove(std::string_view key)
+    {
+        this->BuildEntryMap();
+        auto found = this->entryOf.find(std::string(key));
+        if (found == this->entryOf.end())
+        {
+            return false;
+        }
+        Entry &current = this->entries[found->second];
+        current.removed = true;
+        current.name.clear();
+        this->removedCount++;
+        this->entryOf.erase(found);
+        if (this->removedCount * COMPACT_DIVISOR > this->entries.size())
+        {
+            this->Compact();
+        }
+        return true;
+    }
+
+    // Changes the name indexed for a key, keeping the entry when the lowercase
+    // name is unchanged.
+    // Parameters:
+    //   key  - Key the name was added with.
+    //   name - The new name.
+    // Returns: True if the key was found.
+    bool NameIndex::Update(std::string_view key, std::string_view name)
+    {
+        this->BuildEntryMap();
+        auto found = this->entryOf.find(std::string(key));
+        if (found != this->entryOf.end() && this->entries[found->second].name == Fold(name))
+        {
+            return true;
+        }
+        if (!this->Remove(key))
+        {
+            return false;
+        }
+        this->Add(key, name);
+        return true;
+    }
+
+    // Builds the map from keys to live entries, used by Remove and Update, if it
+    // is not built yet. Once built, Add keeps it up to date.
+    void NameIndex::BuildEntryMap()
+    {
+        if (!this->entryOf.empty())
+        {
+            return;
+        }
+        for (uint32_t i = 0; i < this->entries.size(); i++)
+        {
+            if (!this->entries[i].removed)
+            {
+                this->entryOf[this->entries[i].key] = i;
+            }
+        }
+    }
+
+    // Drops the removed entries. Live entries keep their order, so renumbering
+    // them keeps every posting list ascending. Costs one pass over the postings,
+    // and runs only after a quarter of the entries were removed since the last
+    // pass, so it adds a constant amount of work per removal.
+    void NameIndex::Compact()
+    {
+        const uint32_t dropped = UINT32_MAX;
+        std::vector<uint32_t> renumbered(this->entries.size(), dropped);
+        uint32_t live = 0;
+        for (uint32_t i = 0; i < this->entries.size(); i++)
+        {
+            if (!this->entries[i].removed)
+            {
+                renumbered[i] = live;
+                if (live != i)
+                {
+                    this->entries[live] = std::move(this->entries[i]);
+                }
+                live++;
+            }
+        }
+        this->entries.resize(live);
+        this->entries.shrink_to_fit();
+
+        for (auto list = this->postings.begin(); list != this->postings.end();)
+        {
+            size_t kept = 0;
+            for (uint32_t entry : list->second)
+            {
+                if (renumbered[entry] != dropped)
+                {
+                    list->second[kept++] = renumbered[entry];
+                }
+            }
+            if (kept == 0)
+            {
+                list = this->postings.erase(list);
+                continue;
+            }
+            list->second.resize(kept);
+            list->second.shrink_to_fit();
+            ++list;
+        }
+
+        for (auto &[key, entry] : this->entryOf)
+        {
+            entry = renumbered[entry];
+        }
+        this->removedCount = 0;
+    }
+
+    // Removes every name from the index.
+    void NameIndex::Clear()
+    {
+        this->entries.clear();
+        this->postings.clear();
+        this->removedCount = 0;
+        this->entryOf.clear();
+    }
+
+    // Returns the number of indexed names.
+    size_t NameIndex::GetSize()
+    {
+        return this->entries.size() - this->removedCount;
+    }
+
+    // Returns the entries containing every trigram of a lowercase word, in ascending
+    // order. Intersects the posting lists starting with the shortest, looking each
+    // remaining candidate up by binary search, so the cost follows the shortest list.
+    // Parameters:
+    //   word - Lowercase word of at least three characters.
+    std::vector<uint32_t> NameIndex::Candidates(std::string_view word)
+    {
+        std::vector<const std::vector<uint32_t> *> lists;
+        for (size_t i = 0; i + 3 <= word.size(); i++)
+        {
+            auto found = this->postings.find(Trigram(word.data() + i));
+            if (found == this->postings.end())
+            {
+                return {}; // No name contains this trigram.
+            }
+            lists.push_back(&found->second);
+        }
+        std::sort(lists.begin(), lists.end(), [](const std::vector<uint32_t> *first, const std::vector<uint32_t> *second)
+                  { return first->size() < second->size(); });
+
+        std::vector<uint32_t> result = *lists.front();
+        for (size_t i = 1; i < lists.size() && !result.empty(); i++)
+        {
+            auto position = lists[i]->begin();
+            size_t kept = 0;
+            for (uint32_t entry : result)
+            {
+                position = std::lower_bound(position, lists[i]->end(), entry);
+                if (position == lists[i]->end())
+                {
+                    break;
+                }
+                if (*position == entry)
+                {
+                    result[kept++] = entry;
+                }
+            }
+            result.resize(kept);
+        }
+        return result;
+    }
+
+    // Finds the names containing every word of a query, ignoring case.
+    // Parameters:
+    //   query - Words separated by spaces.
+    // Returns: Keys of the matching names, in the order they were added.
+    std::vector<std::string> NameIndex::Search(std::string_view query)
+    {
+        std::string folded = Fold(query);
+        std::vector<std::string_view> words;
+        size_t start = 0;
+        while (start < folded.size())
+        {
+            size_t space = folded.find(' ', start);
+            if (space == std::string::npos)
+            {
+                space = folded.size();
+            }
+            if (space > start)
+            {
+                words.push_back(std::string_view(folded).substr(start, space - start));
+            }
+            start = space + 1;
+        }
+        if (words.empty())
+        {
+            return {};
+        }
+
+        // Narrow the candidates with every word long enough to have trigrams.
+        bool narrowed = false;
+        std::vector<uint32_t> candidates;
+        for (std::string_view word : words)
+        {
+            if (word.size() < 3)
+            {
+                continue;
+            }
+            std::vector<uint32_t> matches = this->Candidates(word);
+            if (narrowed)
+            {
+                std::vector<uint32_t> both;
+                std::set_intersection(candidates.begin(), candidates.end(), matches.begin(), matches.end(),
+                                      std::back_inserter(both));
+                candidates.swap(both);
+            }
+            else
+            {
+                candidates.swap(matches);
+                narrowed = true;
+            }
+            if (candidates.empty())
+            {
+                return {};
+            }
+        }
+        if (!narrowed)
+        {
+            candidates.resize(this->entries.size());
+            for (uint32_t i = 0; i < candidates.size(); i++)
+            {
+                candidates[i] = i;
+            }
+        }
+
+        // Trigrams only show a word may be present, so check each candidate.
+        std::vector<std::string> keys;
+        for (uint32_t entry : candidates)
+        {
+            const Entry &current = this->entries[entry];
+            if (current.removed)
+            {
+                continue;
+            }
+            bool all = std::all_of(words.begin(), words.end(), [&current](std::string_view word)
+                                   { return current.name.find(word) != std::string::npos; });
+            if (all)
+            {
+                keys.push_back(current.key);
+            }
+        }
+        return keys;
+    }
+
+} // namespace BST
@@ -0,0 +1,103 @@
+//============================================================================
+// Name        : NameIndex.hpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Header file for the course name index of the ABCU Course App.
+//               Every name is split into overlapping three-character pieces
+//               (trigrams) with a posting list of the names containing each one,
+//               so substring and keyword searches only look at likely matches
+//               instead of scanning every course.
+//============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace BST
+{
+
+    // Case-insensitive substring index from names to keys, e.g. course name to course ID.
+    class NameIndex
+    {
+    private:
+        // One indexed name.
+        struct Entry
+        {
+            std::string key;      // Key returned by searches, e.g. the course ID.
+            std::string name;     // Lowercase name.
+            bool removed = false; // True once removed, its postings are left until Compact.
+        };
+
+        // Removed entries are dropped from the postings once they are more than
+        // this fraction (1/4) of all entries, so repeated removals cannot grow
+        // the index without bound.
+        static constexpr size_t COMPACT_DIVISOR = 4;
+
+        std::vector<Entry> entries;                                   // Indexed names, by entry number.
+        std::unordered_map<uint32_t, std::vector<uint32_t>> postings; // Entry numbers containing each trigram, ascending.
+        size_t removedCount = 0;                                      // Entries marked removed.
+        std::unordered_map<std::string, uint32_t> entryOf;            // Live entry of each key, built on first removal or update.
+
+        // Lowercases ASCII letters of a string.
+        static std::string Fold(std::string_view text);
+
+        // Packs three characters into a trigram key.
+        static uint32_t Trigram(const char *text);
+
+        // Returns the entries containing every trigram of a lowercase word, in
+        // ascending order. The word must be at least three characters long.
+        std::vector<uint32_t> Candidates(std::string_view word);
+
+        // Builds the map from keys to live entries if it is not built yet.
+        void BuildEntryMap();
+
+        // Drops the removed entries, renumbering the live ones in order and
+        // taking the removed ones out of every posting list.
+        void Compact();
+
+    public:
+        // Adds a name to the index.
+        // Parameters:
+        //   key  - Key to return when the name matches.
+        //   name - The name to index.
+        void Add(std::string_view key, std::string_view name);
+
+        // Removes a name from the index. The entry is only marked removed, since
+        // taking it out of every posting list would cost more than skipping it,
+        // and the index is compacted once removed entries pile up.
+        // Parameters:
+        //   key - Key the name was added with.
+        //   Returns: True if the entry was found and removed.
+        bool Remove(std::string_view key);
+
+        // Changes the name indexed for a key. A name that only differs in case
+        // keeps its entry, any other replaces it.
+        // Parameters:
+        //   key  - Key the name was added with.
+        //   name - The new name.
+        //   Returns: True if the key was found.
+        bool Update(std::string_view key, std::string_view name);
+
+        // Removes every name from the index.
+        void Clear();
+
+        // Returns the number of indexed names.
+        size_t GetSize();
+
+        // Finds the names containing every word of a query, ignoring case. Each word
+        // matches anywhere in the name, so "calc" finds "Calculus" and "physics 2"
+        // finds "Physics 2" and "Physics 201". Words of three or more characters are
+        // looked up in the trigram postings, starting with the shortest list, so the
+        // work follows the size of the result. A query with only shorter words has
+        // no trigrams to use and falls back to checking every name.
+        // Parameters:
+        //   query - Words separated by spaces.
+        //   Returns: Keys of the matching names, in the order they were added.
+        std::vector<std::string> Search(std::string_view query);
+    };
+
+} // namespace BST
@@ -0,0 +1,416 @@
+//============================================================================
+// Name        : PersistentTree.hpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Header file defining the persistent (versioned) Binary Search Tree
+//               of the ABCU Course App. Every copy of a PersistentTree is a
+//               version. Updates copy only the path from the root to the change
+//               and share every other subtree with the versions before them, so
+//               old catalogs stay readable while a new one is staged, and two
+//               versions can be compared by skipping what they share.
+//============================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "BST.hpp"
+
+namespace BST
+{
+
+    // Persistent AVL tree using the same key and comparison policies as
+    // BinarySearchTree. Copying a tree is O(1) and gives an independent version;
+    // Insert, Update and Remove copy O(log n) nodes and leave other versions untouched.
+    template <typename Value, typename KeyOf, typename Compare>
+    class PersistentTree
+    {
+    public:
+        // Type of the key returned by KeyOf.
+        using Key = typename BinarySearchTree<Value, KeyOf, Compare>::Key;
+
+    private:
+        // Immutable node. Values are held through a pointer so copying a path
+        // copies pointers, never the values themselves.
+        struct Node
+        {
+            std::shared_ptr<const Value> value; // Data stored in the node.
+            std::shared_ptr<const Node> left;   // Left subtree, shared between versions.
+            std::shared_ptr<const Node> right;  // Right subtree, shared between versions.
+            int height;                         // Height of the subtree rooted here, a leaf is 1.
+        };
+        using NodePtr = std::shared_ptr<const Node>;
+
+        // One step of a walk from the root: the node and the side taken below it.
+        struct Step
+        {
+            const Node *node; // Node on the path.
+            bool wentLeft;    // True if the walk continued into the left subtree.
+        };
+
+        NodePtr root;    // Root of this version.
+        int size = 0;    // Number of values in this version.
+        KeyOf keyOf;     // Key extraction policy.
+        Compare compare; // Key comparison policy.
+
+        // Returns the height of a subtree, 0 for an empty one.
+        static int GetHeight(const NodePtr &node)
+        {
+            return node ? node->height : 0;
+        }
+
+        // Makes a new node over two subtrees that are already balanced with each other.
+        static NodePtr MakeNode(std::shared_ptr<const Value> value, NodePtr left, NodePtr right)
+        {
+            int height = 1 + std::max(GetHeight(left), GetHeight(right));
+            return std::make_shared<const Node>(Node{std::move(value), std::move(left), std::move(right), height});
+        }
+
+        // Makes a new node over two subtrees whose heights differ by at most two,
+        // rotating with new nodes where needed so the result is balanced (AVL).
+        static NodePtr Balance(std::shared_ptr<const Value> value, NodePtr left, NodePtr right)
+        {
+            int balance = GetHeight(left) - GetHeight(right);
+            if (balance > 1)
+            {
+                if (GetHeight(left->left) >= GetHeight(left->right))
+                {
+                    return MakeNode(left->value, left->left, MakeNode(std::move(value), left->right, std::move(right)));
+                }
+                const NodePtr &pivot = left->right;
+                return MakeNode(pivot->value, MakeNode(left->value, left->left, pivot->left),
+                                MakeNode(std::move(value), pivot->right, std::move(right)));
+            }
+            if (balance < -1)
+            {
+                if (GetHeight(right->right) >= GetHeight(right->left))
+                {
+                    return MakeNode(right->value, MakeNode(std::move(value), std::move(left), right->left), right->right);
+                }
+                const NodePtr &pivot = right->left;
+                return MakeNode(pivot->value, MakeNode(std::move(value), std::move(left), pivot->left),
+                                MakeNode(right->value, pivot->right, right->right));
+            }
+            return MakeNode(std::move(value), std::move(left), std::move(right));
+        }
+
+        // Copies a path bottom-up, hanging the new subtree below its last step and
+        // rebalancing each copied node.
+        // Parameters:
+        //   path    - Steps from the root down to the parent of the replaced subtree.
+        //   subtree - The new subtree.
+        //   Returns: The root of the new version.
+        static NodePtr RebuildPath(const std::vector<Step> &path, NodePtr subtree)
+        {
+            for (size_t i = path.size(); i-- > 0;)
+            {
+                const Node *node = path[i].node;
+                subtree = path[i].wentLeft ? Balance(node->value, std::move(subtree), node->right)
+                                           : Balance(node->value, node->left, std::move(subtree));
+            }
+            return subtree;
+        }
+
+        // Walks down from the root towards a key, recording the path for the
+        // operations that copy it. Lookups use Find, which keeps no path.
+        // Parameters:
+        //   key  - The key to look for.
+        //   path - Receives the steps taken before the key or an empty subtree was reached.
+        //   Returns: The node holding the key, or nullptr if there is none.
+        const Node *Descend(const Key &key, std::vector<Step> &path) const
+        {
+            path.reserve(GetHeight(this->root));
+            const Node *node = this->root.get();
+            while (node != nullptr)
+            {
+                int result = this->compare(this->keyOf(*node->value), key);
+                if (result == 0)
+                {
+                    return node;
+                }
+                path.push_back(Step{node, result > 0});
+                node = result > 0 ? node->left.get() : node->right.get();
+            }
+            return nullptr;
+        }
+
+        // Returns a subtree without its smallest value, which is stored in smallest.
+        static NodePtr RemoveMin(const NodePtr &subtree, std::shared_ptr<const Value> &smallest)
+        {
+            std::vector<Step> path;
+            const Node *node = subtree.get();
+            while (node->left)
+            {
+                path.push_back(Step{node, true});
+                node = node->left.get();
+            }
+            smallest = node->value;
+            return RebuildPath(path, node->right);
+        }
+
+        // Called recursively to build a balanced subtree from the values in
+        // [start, end). The recursion depth is only log2 of the number of values.
+        static NodePtr BuildBalancedTree(std::vector<Value> &values, size_t start, size_t end)
+        {
+            if (start >= end)
+            {
+                return nullptr;
+            }
+            size_t mid = start + (end - start) / 2;
+            NodePtr left = BuildBalancedTree(values, start, mid);
+            NodePtr right = BuildBalancedTree(values, mid + 1, end);
+            return MakeNode(std::make_shared<const Value>(std::move(values[mid])), std::move(left), std::move(right));
+        }
+
+        // One frame of the walk used by Diff: a subtree still to visit whole, or a
+        // node whose left subtree is done and whose value is next.
+        struct Frame
+        {
+            const Node *node; // The subtree or node.
+            bool expanded;    // False for a whole subtree, true for the node's own value.
+        };
+
+        // Replaces a whole-subtree frame on top of a stack by its node and left subtree.
+        static void Expand(std::vector<Frame> &stack)
+        {
+            const Node *node = stack.back().node;
+            stack.back().expanded = true;
+            if (node->left)
+            {
+                stack.push_back(Frame{node->left.get(), false});
+            }
+        }
+
+        // Moves past the value on top of a stack to the node's right subtree.
+        static void Advance(std::vector<Frame> &stack)
+        {
+            const Node *node = stack.back().node;
+            stack.pop_back();
+            if (node->right)
+            {
+                stack.push_back(Frame{node->right.get(), false});
+            }
+        }
+
+    public:
+        // Returns the number of values in this version.
+        int GetSize() const
+        {
+            return this->size;
+        }
+
+        // Returns the height of this version.
+        int GetHeight() const
+        {
+            return GetHeight(this->root);
+        }
+
+        // Searches for a value by key.
+        // Parameters:
+        //   key - The key to search for.
+        //   Returns: Pointer to the value, or nullptr if there is none. The value lives
+        //            as long as any version holding it.
+        const Value *Find(const Key &key) const
+        {
+            const Node *node = this->root.get();
+            while (node != nullptr)
+            {
+                int result = this->compare(this->keyOf(*node->value), key);
+                if (result == 0)
+                {
+                    return node->value.get();
+                }
+                node = result > 0 ? node->left.get() : node->right.get();
+            }
+            return nullptr;
+        }
+
+        // Inserts a value into this version.
+        // Parameters:
+        //   value - The value to insert.
+        //   Returns: True if inserted, false if the key already exists.
+        bool Insert(Value value)
+        {
+            std::vector<Step> path;
+            if (this->Descend(this->keyOf(value), path) != nullptr)
+            {
+                return false;
+            }
+            NodePtr leaf = MakeNode(std::make_shared<const Value>(std::move(value)), nullptr, nullptr);
+            this->root = RebuildPath(path, std::move(leaf));
+            this->size++;
+            return true;
+        }
+
+        // Replaces the value with the same key in this version.
+        // Parameters:
+        //   value - The new value.
+        //   Returns: True if replaced, false if the key does not exist.
+        bool Update(Value value)
+        {
+            std::vector<Step> path;
+            const Node *node = this->Descend(this->keyOf(value), path);
+            if (node == nullptr)
+            {
+                return false;
+            }
+            NodePtr replaced = MakeNode(std::make_shared<const Value>(std::move(value)), node->left, node->right);
+            this->root = RebuildPath(path, std::move(replaced));
+            return true;
+        }
+
+        // Removes the value with a key from this version.
+        // Parameters:
+        //   key - The key to remove.
+        //   Returns: True if removed, false if the key does not exist.
+        bool Remove(const Key &key)
+        {
+            std::vector<Step> path;
+            const Node *node = this->Descend(key, path);
+            if (node == nullptr)
+            {
+                return false;
+            }
+            NodePtr replacement;
+            if (!node->left || !node->right)
+            {
+                replacement = node->left ? node->left : node->right;
+            }
+            else
+            {
+                // Replace the node by the smallest value of its right subtree.
+                std::shared_ptr<const Value> smallest;
+                NodePtr right = RemoveMin(node->right, smallest);
+                replacement = Balance(std::move(smallest), node->left, std::move(right));
+            }
+            this->root = RebuildPath(path, std::move(replacement));
+            this->size--;
+            return true;
+        }
+
+        // Replaces this version with values that are already sorted by key and free
+        // of duplicates, building it balanced in one pass.
+        // Parameters:
+        //   values - Ordered vector of unique values, moved into the new nodes.
+        void BuildFromSorted(std::vector<Value> values)
+        {
+            this->root = BuildBalancedTree(values, 0, values.size());
+            this->size = static_cast<int>(values.size());
+        }
+
+        // Calls a function with every value of this version in key order.
+        // Parameters:
+        //   visit - Function taking a const reference to a value.
+        template <typename Visit>
+        void ForEachInOrder(Visit visit) const
+        {
+            std::vector<const Node *> stack;
+            const Node *node = this->root.get();
+            while (node != nullptr || !stack.empty())
+            {
+                while (node != nullptr)
+                {
+                    stack.push_back(node);
+                    node = node->left.get();
+                }
+                node = stack.back();
+                stack.pop_back();
+                visit(*node->value);
+                node = node->right.get();
+            }
+        }
+
+        // Lists the differences between two versions in key order. Subtrees the two
+        // versions share are skipped without being visited, so comparing versions
+        // a few updates apart costs about O(changes * log n).
+        // Parameters:
+        //   older     - The earlier version.
+        //   newer     - The later version.
+        //   onAdded   - Called with each value only in newer.
+        //   onRemoved - Called with each value only in older.
+        //   onChanged - Called with the old and new value of each key that was updated.
+        template <typename Added, typename Removed, typename Changed>
+        static void Diff(const PersistentTree &older, const PersistentTree &newer, Added onAdded, Removed onRemoved,
+                         Changed onChanged)
+        {
+            std::vector<Frame> oldStack;
+            std::vector<Frame> newStack;
+            if (older.root)
+            {
+                oldStack.push_back(Frame{older.root.get(), false});
+            }
+            if (newer.root)
+            {
+                newStack.push_back(Frame{newer.root.get(), false});
+            }
+
+            while (!oldStack.empty() || !newStack.empty())
+            {
+                bool oldWhole = !oldStack.empty() && !oldStack.back().expanded;
+                bool newWhole = !newStack.empty() && !newStack.back().expanded;
+
+                // A subtree both versions share holds the same values, skip it.
+                if (oldWhole && newWhole && oldStack.back().node == newStack.back().node)
+                {
+                    oldStack.pop_back();
+                    newStack.pop_back();
+                    continue;
+                }
+
+                // Open whole subtrees until both sides have a value on top, taller
+                // side first so shared subtrees below it line up with the other side.
+                if (oldWhole && (!newWhole || oldStack.back().node->height >= newStack.back().node->height))
+                {
+                    Expand(oldStack);
+                    continue;
+                }
+                if (newWhole)
+                {
+                    Expand(newStack);
+                    continue;
+                }
+
+                // Both tops are values, or one side is finished.
+                if (newStack.empty())
+                {
+                    onRemoved(*oldStack.back().node->value);
+                    Advance(oldStack);
+                    continue;
+                }
+                if (oldStack.empty())
+                {
+                    onAdded(*newStack.back().node->value);
+                    Advance(newStack);
+                    continue;
+                }
+                const Node *oldNode = oldStack.back().node;
+                const Node *newNode = newStack.back().node;
+                int result = older.compare(older.keyOf(*oldNode->value), newer.keyOf(*newNode->value));
+                if (result < 0)
+                {
+                    onRemoved(*oldNode->value);
+                    Advance(oldStack);
+                }
+                else if (result > 0)
+                {
+                    onAdded(*newNode->value);
+                    Advance(newStack);
+                }
+                else
+                {
+                    // Rotations move values between nodes but never copy them, so a
+                    // different value pointer means the value was updated.
+                    if (oldNode->value != newNode->value)
+                    {
+                        onChanged(*oldNode->value, *newNode->value);
+                    }
+                    Advance(oldStack);
+                    Advance(newStack);
+                }
+            }
+        }
+    };
+
+} // namespace BST
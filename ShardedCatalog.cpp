@@ -0,0 +1,526 @@
+//============================================================================
+// Name        : ShardedCatalog.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Implementation file for the department-sharded catalog of the
+//               ABCU Course App. Worker threads take shards from a shared
+//               counter, so a few large departments do not hold up the rest.
+//============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+#include "ShardedCatalog.hpp"
+
+namespace BST
+{
+
+    namespace
+    {
+        // Returns the number of letters at the start of a course ID.
+        size_t DepartmentLength(std::string_view courseId)
+        {
+            size_t length = 0;
+            while (length < courseId.size() && std::isalpha(static_cast<unsigned char>(courseId[length])))
+            {
+                length++;
+            }
+            return length;
+        }
+
+        // Checks whether a course ID belongs to a department without building its
+        // department string.
+        // Parameters:
+        //   courseId   - The course ID.
+        //   department - A lowercase department.
+        bool InDepartment(std::string_view courseId, const std::string &department)
+        {
+            if (DepartmentLength(courseId) != department.size())
+            {
+                return false;
+            }
+            for (size_t i = 0; i < department.size(); i++)
+            {
+                if (NoCaseCompare::Fold(courseId[i]) != department[i])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Runs job(i) for i in [0, count) on up to threadCount threads, each taking
+        // the next index from a shared counter, and waits for all of them.
+        template <typename Job>
+        void RunOnWorkers(size_t count, unsigned int threadCount, Job job)
+        {
+            std::atomic<size_t> next{0};
+            std::vector<std::thread> workers;
+            size_t workerCount = std::min<size_t>(count, threadCount);
+            for (size_t w = 0; w < workerCount; w++)
+            {
+                workers.emplace_back([&]()
+                                     {
+                    for (size_t i = next++; i < count; i = next++)
+                    {
+                        job(i);
+                    } });
+            }
+            for (std::thread &worker : workers)
+            {
+                worker.join();
+            }
+        }
+
+        // Returns the thread count to use, every hardware thread for 0.
+        unsigned int ResolveThreads(unsigned int threadCount)
+        {
+            return threadCount == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threadCount;
+        }
+    }
+
+    // Returns the department of a course ID: its leading letters, lowercased.
+    // Parameters:
+    //   courseId - The course ID.
+    // Returns: The department, or "" if the ID starts with no letter.
+    std::string DepartmentOf(std::string_view courseId)
+    {
+        std::string department(courseId.substr(0, DepartmentLength(courseId)));
+        std::transform(department.begin(), department.end(), department.begin(), NoCaseCompare::Fold);
+        return department;
+    }
+
+    // Returns the shard of a course ID. The caller holds directoryLock.
+    // Parameters:
+    //   courseId - The course ID.
+    // Returns: The shard, or nullptr if its department has none.
+    ShardedCatalog::Shard *ShardedCatalog::FindShard(std::string_view courseId)
+    {
+        auto found = this->shardOf.find(DepartmentOf(courseId));
+        return found == this->shardOf.end() ? nullptr : found->second;
+    }
+
+    // Replaces the catalog with batches of courses in file order.
+    // Parameters:
+    //   batches     - Courses in file order, moved from.
+    //   threadCount - Number of worker threads, 0 to use every hardware thread.
+    // Returns: True if every course is valid, false otherwise.
+    bool ShardedCatalog::Build(std::vector<std::vector<Course>> batches, unsigned int threadCount)
+    {
+        std::unique_lock<std::shared_mutex> directory(this->directoryLock);
+        threadCount = ResolveThreads(threadCount);
+
+        // Line number of the first course of each batch, to report duplicates in file order.
+        std::vector<size_t> offsets(batches.size() + 1, 0);
+        for (size_t b = 0; b < batches.size(); b++)
+        {
+            offsets[b + 1] = offsets[b] + batches[b].size();
+        }
+
+        // Split every batch by department, keeping file order within each part.
+        using Placed = std::pair<size_t, Course>;
+        std::vector<std::unordered_map<std::string, std::vector<Placed>>> parts(batches.size());
+        RunOnWorkers(batches.size(), threadCount, [&](size_t b)
+                     {
+            for (size_t i = 0; i < batches[b].size(); i++)
+            {
+                std::string department = DepartmentOf(batches[b][i].courseId);
+                parts[b][department].emplace_back(offsets[b] + i, std::move(batches[b][i]));
+            }
+            batches[b].clear(); });
+
+        // One shard per department, in department order.
+        std::vector<std::string> departments;
+        for (const auto &part : parts)
+        {
+            for (const auto &entry : part)
+            {
+                departments.push_back(entry.first);
+            }
+        }
+        std::sort(departments.begin(), departments.end());
+        departments.erase(std::unique(departments.begin(), departments.end()), departments.end());
+        this->shards.clear();
+        this->shardOf.clear();
+        for (const std::string &department : departments)
+        {
+            this->shards.push_back(std::make_unique<Shard>());
+            this->shards.back()->department = department;
+            this->shardOf[department] = this->shards.back().get();
+        }
+
+        // Gather each department's courses, sort them, drop duplicate IDs and
+        // build the shard balanced. The stable sort keeps the first occurrence first.
+        std::vector<std::vector<std::pair<size_t, std::string>>> duplicates(this->shards.size());
+        RunOnWorkers(this->shards.size(), threadCount, [&](size_t s)
+                     {
+            Shard &shard = *this->shards[s];
+            std::vector<Placed> placed;
+            for (auto &part : parts)
+            {
+                auto found = part.find(shard.department);
+                if (found != part.end())
+                {
+                    std::move(found->second.begin(), found->second.end(), std::back_inserter(placed));
+                    found->second.clear();
+                }
+            }
+            NoCaseCompare compare;
+            std::stable_sort(placed.begin(), placed.end(), [&compare](const Placed &first, const Placed &second)
+                             { return compare(first.second.courseId, second.second.courseId) < 0; });
+            std::vector<Course> courses;
+            courses.reserve(placed.size());
+            for (size_t i = 0; i < placed.size(); i++)
+            {
+                if (!courses.empty() && compare(placed[i].second.courseId, courses.back().courseId) == 0)
+                {
+                    duplicates[s].emplace_back(placed[i].first, placed[i].second.courseId);
+                }
+                else
+                {
+                    courses.push_back(std::move(placed[i].second));
+                }
+            }
+            shard.tree.BuildFromSorted(std::move(courses)); });
+
+        std::vector<std::pair<size_t, std::string>> reported;
+        for (auto &shardDuplicates : duplicates)
+        {
+            std::move(shardDuplicates.begin(), shardDuplicates.end(), std::back_inserter(reported));
+        }
+        std::sort(reported.begin(), reported.end());
+        for (const auto &[line, courseId] : reported)
+        {
+            std::cout << "Not inserted: " << courseId << std::endl;
+        }
+
+        return this->ValidateShards(threadCount);
+    }
+
+    // Validates every course, shards in parallel, reporting bad courses in order.
+    // Parameters:
+    //   threadCount - Number of worker threads, 0 to use every hardware thread.
+    // Returns: True if every course is valid, false otherwise.
+    bool ShardedCatalog::ValidateCourses(unsigned int threadCount)
+    {
+        std::shared_lock<std::shared_mutex> directory(this->directoryLock);
+        return this->ValidateShards(ResolveThreads(threadCount));
+    }
+
+    // Checks every shard on worker threads, then resolves the prerequisites in
+    // other departments in a final pass. The caller holds directoryLock.
+    // Parameters:
+    //   threadCount - Number of worker threads.
+    // Returns: True if every course is valid, false otherwise.
+    bool ShardedCatalog::ValidateShards(unsigned int threadCount)
+    {
+        ScopedLatency timer(LatencyOperation::ValidateCourses);
+
+        // A prerequisite in another department, resolved once every shard is checked.
+        struct CrossReference
+        {
+            const Course *course;       // Course listing the prerequisite.
+            const std::string *prereq;  // The prerequisite ID.
+        };
+
+        size_t shardCount = this->shards.size();
+        std::vector<char> lengthsValid(shardCount, 1);
+        std::vector<std::vector<std::string>> badCourses(shardCount);
+        std::vector<std::vector<CrossReference>> crossReferences(shardCount);
+
+        // Pass 1: lengths and prerequisites within the same department.
+        RunOnWorkers(shardCount, threadCount, [&](size_t s)
+                     {
+            Shard &shard = *this->shards[s];
+            std::shared_lock<std::shared_mutex> lock(shard.lock);
+            shard.tree.ForEachInOrder([&](const Course &course)
+                                      {
+                if (!CourseTree::HasValidLengths(course.courseId, course.courseName))
+                {
+                    lengthsValid[s] = 0;
+                }
+                bool missing = false;
+                for (const std::string &prereq : course.prereqs)
+                {
+                    if (!InDepartment(prereq, shard.department))
+                    {
+                        crossReferences[s].push_back(CrossReference{&course, &prereq});
+                    }
+                    else if (shard.tree.Find(prereq) == nullptr)
+                    {
+                        missing = true;
+                    }
+                }
+                if (missing)
+                {
+                    badCourses[s].push_back(course.courseId);
+                } }); });
+
+        // Pass 2: prerequisites in other departments, each looked up in its own shard.
+        RunOnWorkers(shardCount, threadCount, [&](size_t s)
+                     {
+            for (const CrossReference &reference : crossReferences[s])
+            {
+                Shard *target = this->FindShard(*reference.prereq);
+                bool found = false;
+                if (target != nullptr)
+                {
+                    std::shared_lock<std::shared_mutex> lock(target->lock);
+                    found = target->tree.Find(*reference.prereq) != nullptr;
+                }
+                if (!found)
+                {
+                    badCourses[s].push_back(reference.course->courseId);
+                }
+            } });
+
+        // Report each bad course once, in ID order as CourseTree does.
+        std::vector<std::string> reported;
+        for (auto &shardBad : badCourses)
+        {
+            std::move(shardBad.begin(), shardBad.end(), std::back_inserter(reported));
+        }
+        NoCaseCompare compare;
+        std::sort(reported.begin(), reported.end(), [&compare](const std::string &first, const std::string &second)
+                  { return compare(first, second) < 0; });
+        reported.erase(std::unique(reported.begin(), reported.end()), reported.end());
+        for (const std::string &courseId : reported)
+        {
+            std::cout << "Bad Course: " << courseId << std::endl;
+        }
+
+        bool lengthsGood = std::all_of(lengthsValid.begin(), lengthsValid.end(), [](char valid)
+                                       { return valid != 0; });
+        return lengthsGood && reported.empty();
+    }
+
+    // Inserts a course into its department's shard, adding the shard if needed.
+    // Parameters:
+    //   course - The course to insert.
+    // Returns: True if inserted, false if the ID already exists.
+    bool ShardedCatalog::Insert(Course course)
+    {
+        {
+            std::shared_lock<std::shared_mutex> directory(this->directoryLock);
+            Shard *shard = this->FindShard(course.courseId);
+            if (shard != nullptr)
+            {
+                std::unique_lock<std::shared_mutex> lock(shard->lock);
+                return shard->tree.Insert(std::move(course));
+            }
+        }
+
+        // New department: add its shard, unless another thread just did.
+        std::unique_lock<std::shared_mutex> directory(this->directoryLock);
+        Shard *shard = this->FindShard(course.courseId);
+        if (shard == nullptr)
+        {
+            std::string department = DepartmentOf(course.courseId);
+            auto position = std::lower_bound(this->shards.begin(), this->shards.end(), department,
+                                             [](const std::unique_ptr<Shard> &existing, const std::string &wanted)
+                                             { return existing->department < wanted; });
+            position = this->shards.insert(position, std::make_unique<Shard>());
+            (*position)->department = department;
+            shard = position->get();
+            this->shardOf[department] = shard;
+        }
+        std::unique_lock<std::shared_mutex> lock(shard->lock);
+        return shard->tree.Insert(std::move(course));
+    }
+
+    // Copies a course out of its shard.
+    // Parameters:
+    //   courseId - The course ID to look up.
+    //   course   - Receives the course if found.
+    // Returns: True if the course exists, false otherwise.
+    bool ShardedCatalog::Find(const std::string &courseId, Course *course)
+    {
+        std::shared_lock<std::shared_mutex> directory(this->directoryLock);
+        Shard *shard = this->FindShard(courseId);
+        if (shard == nullptr)
+        {
+            return false;
+        }
+        std::shared_lock<std::shared_mutex> lock(shard->lock);
+        Course *found = shard->tree.Find(courseId);
+        if (found != nullptr && course != nullptr)
+        {
+            *course = *found;
+        }
+        return found != nullptr;
+    }
+
+    // Returns the courses of one department in order, touching only its shard.
+    // Parameters:
+    //   department - Department letters, in any case.
+    // Returns: The department's courses, empty if it has none.
+    std::vector<Course> ShardedCatalog::GetDepartment(std::string_view department)
+    {
+        std::shared_lock<std::shared_mutex> directory(this->directoryLock);
+        std::string folded(department);
+        std::transform(folded.begin(), folded.end(), folded.begin(), NoCaseCompare::Fold);
+        auto found = this->shardOf.find(folded);
+        if (found == this->shardOf.end())
+        {
+            return {};
+        }
+        std::shared_lock<std::shared_mutex> lock(found->second->lock);
+        return found->second->tree.GetInOrder();
+    }
+
+    // Visits every course in ID order by merging the shards. Each shard is read
+    // in order once and a heap picks the smallest next ID among them.
+    // Parameters:
+    //   visit - Function called with each course, smallest ID first.
+    template <typename Visit>
+    void ShardedCatalog::MergeShards(Visit visit)
+    {
+        std::shared_lock<std::shared_mutex> directory(this->directoryLock);
+        std::vector<std::shared_lock<std::shared_mutex>> locks;
+        std::vector<std::vector<const Course *>> runs(this->shards.size());
+        for (size_t s = 0; s < this->shards.size(); s++)
+        {
+            locks.emplace_back(this->shards[s]->lock);
+            runs[s].reserve(this->shards[s]->tree.GetSize());
+            this->shards[s]->tree.ForEachInOrder([&runs, s](const Course &course)
+                                                 { runs[s].push_back(&course); });
+        }
+
+        // Heap of (run, position) pairs, smallest course ID on top.
+        NoCaseCompare compare;
+        using Cursor = std::pair<size_t, size_t>;
+        auto greater = [&](const Cursor &first, const Cursor &second)
+        {
+            return compare(runs[first.first][first.second]->courseId, runs[second.first][second.second]->courseId) > 0;
+        };
+        std::priority_queue<Cursor, std::vector<Cursor>, decltype(greater)> heap(greater);
+        for (size_t s = 0; s < runs.size(); s++)
+        {
+            if (!runs[s].empty())
+            {
+                heap.emplace(s, 0);
+            }
+        }
+        while (!heap.empty())
+        {
+            Cursor top = heap.top();
+            heap.pop();
+            visit(*runs[top.first][top.second]);
+            if (top.second + 1 < runs[top.first].size())
+            {
+                heap.emplace(top.first, top.second + 1);
+            }
+        }
+    }
+
+    // Returns every course in order by merging the shards.
+    std::vector<Course> ShardedCatalog::GetCoursesInOrder()
+    {
+        std::vector<Course> courses;
+        this->MergeShards([&courses](const Course &course)
+                          { courses.push_back(course); });
+        return courses;
+    }
+
+    // Prints the ID and name of every course in order, merging the shards.
+    void ShardedCatalog::PrintOrdered()
+    {
+        ScopedLatency timer(LatencyOperation::PrintOrdered);
+        this->MergeShards([](const Course &course)
+                          { CourseTree::PrintIdDescription(course); });
+    }
+
+    // Returns the course IDs closest to one that was not found. A typo can change
+    // the department, so every shard is searched, each under its shared lock.
+    // A shard with nothing one edit away answers with IDs two edits away, so
+    // only the closest distance any shard found is kept, which gives the same
+    // answer as one index over every ID.
+    // Parameters:
+    //   courseId - The mistyped course ID.
+    //   limit    - Most suggestions to return.
+    // Returns: Suggested IDs, closest first and then by ID.
+    std::vector<std::string> ShardedCatalog::SuggestIds(const std::string &courseId, size_t limit)
+    {
+        ScopedLatency timer(LatencyOperation::Suggest);
+        std::vector<std::pair<int, std::string>> found;
+        {
+            std::shared_lock<std::shared_mutex> directory(this->directoryLock);
+            for (const std::unique_ptr<Shard> &shard : this->shards)
+            {
+                std::shared_lock<std::shared_mutex> lock(shard->lock);
+                ShardTree &tree = shard->tree;
+                auto idAt = [&tree](size_t index) -> std::string_view
+                { return tree.Select(static_cast<int>(index))->courseId; };
+                for (const std::pair<int, size_t> &match : SuggestSortedIds<NoCaseCompare>(
+                         tree.GetSize(), idAt, [](size_t)
+                         { return true; },
+                         courseId, limit))
+                {
+                    found.emplace_back(match.first, std::string(idAt(match.second)));
+                }
+            }
+        }
+
+        NoCaseCompare compare;
+        std::sort(found.begin(), found.end(), [&compare](const std::pair<int, std::string> &first, const std::pair<int, std::string> &second)
+                  { return first.first != second.first ? first.first < second.first : compare(first.second, second.second) < 0; });
+        std::vector<std::string> suggestions;
+        for (size_t i = 0; i < found.size() && suggestions.size() < limit && found[i].first == found.front().first; i++)
+        {
+            suggestions.push_back(std::move(found[i].second));
+        }
+        return suggestions;
+    }
+
+    // Prints one course with its prerequisites, or "Course not found." and any
+    // suggested IDs.
+    // Parameters:
+    //   courseId - The course ID to print.
+    void ShardedCatalog::PrintSingleCourse(const std::string &courseId)
+    {
+        ScopedLatency timer(LatencyOperation::Lookup);
+        Course course;
+        if (this->Find(courseId, &course))
+        {
+            CourseTree::PrintCourse(course);
+        }
+        else
+        {
+            CourseTree::PrintNotFound(this->SuggestIds(courseId));
+        }
+    }
+
+    // Returns the number of courses in every shard.
+    int ShardedCatalog::GetSize()
+    {
+        std::shared_lock<std::shared_mutex> directory(this->directoryLock);
+        int size = 0;
+        for (const std::unique_ptr<Shard> &shard : this->shards)
+        {
+            std::shared_lock<std::shared_mutex> lock(shard->lock);
+            size += shard->tree.GetSize();
+        }
+        return size;
+    }
+
+    // Returns the number of departments.
+    size_t ShardedCatalog::GetShardCount()
+    {
+        std::shared_lock<std::shared_mutex> directory(this->directoryLock);
+        return this->shards.size();
+    }
+
+    // Removes every course and shard.
+    void ShardedCatalog::Clear()
+    {
+        std::unique_lock<std::shared_mutex> directory(this->directoryLock);
+        this->shards.clear();
+        this->shardOf.clear();
+    }
+
+} // namespace BST
@@ -0,0 +1,141 @@
+//============================================================================
+// Name        : ShardedCatalog.hpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Header file for the department-sharded catalog of the ABCU Course
+//               App. Courses are split by the letters that start their IDs
+//               (MATH, PHYS, CSCI...) into independent trees, each with its own
+//               lock. Shards are built and validated in parallel, a department
+//               listing touches one shard, and full listings merge the shards.
+//============================================================================
+
+#pragma once
+
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "BST.hpp"
+
+namespace BST
+{
+
+    // Returns the department of a course ID: its leading letters, lowercased.
+    // Parameters:
+    //   courseId - The course ID, e.g. "CSCI300".
+    //   Returns: The department, e.g. "csci", or "" if the ID starts with no letter.
+    std::string DepartmentOf(std::string_view courseId);
+
+    // Catalog of courses partitioned by department into BinarySearchTree shards.
+    // Readers of a shard share its lock and writers hold it alone, so threads
+    // working in different departments never wait for each other. The directory
+    // of shards has a lock of its own, held alone only to add a department.
+    // ABCU_STATS counters are kept per shard as relaxed atomics, so readers
+    // sharing a shard's lock can count concurrently.
+    class ShardedCatalog
+    {
+    private:
+        using ShardTree = BinarySearchTree<Course, CourseIdOf, NoCaseCompare>;
+
+        // One department's courses.
+        struct Shard
+        {
+            std::string department;  // Lowercase department of every course in the shard.
+            ShardTree tree;          // The department's courses by ID.
+            std::shared_mutex lock;  // Shared by readers, held alone by writers.
+        };
+
+        std::vector<std::unique_ptr<Shard>> shards;      // Shards in department order.
+        std::unordered_map<std::string, Shard *> shardOf; // Shard of each department.
+        std::shared_mutex directoryLock;                 // Guards shards and shardOf.
+
+        // Returns the shard of a course ID. The caller holds directoryLock.
+        // Parameters:
+        //   courseId - The course ID.
+        //   Returns: The shard, or nullptr if its department has none.
+        Shard *FindShard(std::string_view courseId);
+
+        // Checks every shard's courses, lengths and same-department prerequisites
+        // on worker threads, then resolves the prerequisites in other departments
+        // in a final pass. The caller holds directoryLock.
+        // Parameters:
+        //   threadCount - Number of worker threads.
+        //   Returns: True if every course is valid.
+        bool ValidateShards(unsigned int threadCount);
+
+        // Visits every course in ID order by merging the shards, holding every
+        // shard's lock shared until the last course is visited.
+        // Parameters:
+        //   visit - Function called with each course, smallest ID first.
+        template <typename Visit>
+        void MergeShards(Visit visit);
+
+    public:
+        // Replaces the catalog with batches of courses, e.g. one per parsing
+        // thread, in file order. Batches are split into departments and every
+        // shard is sorted, built balanced and validated on worker threads. The
+        // first course with an ID is kept and later ones are reported.
+        // Parameters:
+        //   batches     - Courses in file order, moved from.
+        //   threadCount - Number of worker threads, 0 to use every hardware thread.
+        //   Returns: True if every course is valid.
+        bool Build(std::vector<std::vector<Course>> batches, unsigned int threadCount);
+
+        // Validates every course, shards in parallel, reporting bad courses in order.
+        // Parameters:
+        //   threadCount - Number of worker threads, 0 to use every hardware thread.
+        //   Returns: True if every course is valid.
+        bool ValidateCourses(unsigned int threadCount);
+
+        // Inserts a course into its department's shard, adding the shard if needed.
+        // Parameters:
+        //   course - The course to insert.
+        //   Returns: True if inserted, false if the ID already exists.
+        bool Insert(Course course);
+
+        // Copies a course out of its shard.
+        // Parameters:
+        //   courseId - The course ID to look up.
+        //   course   - Receives the course if found.
+        //   Returns: True if the course exists.
+        bool Find(const std::string &courseId, Course *course);
+
+        // Returns the courses of one department in order, touching only its shard.
+        // Parameters:
+        //   department - Department letters, in any case, e.g. "MATH".
+        std::vector<Course> GetDepartment(std::string_view department);
+
+        // Returns every course in order by merging the shards.
+        std::vector<Course> GetCoursesInOrder();
+
+        // Prints the ID and name of every course in order, merging the shards.
+        void PrintOrdered();
+
+        // Returns the course IDs closest to one that was not found, as
+        // CourseTree::SuggestIds does. Each shard's tree is walked as a sorted
+        // ID array through Select, and the shards' answers are merged.
+        // Parameters:
+        //   courseId - The mistyped course ID.
+        //   limit    - Most suggestions to return.
+        //   Returns: Suggested IDs, closest first and then by ID.
+        std::vector<std::string> SuggestIds(const std::string &courseId, size_t limit = 5);
+
+        // Prints one course with its prerequisites, or "Course not found." and
+        // any suggested IDs.
+        // Parameters:
+        //   courseId - The course ID to print.
+        void PrintSingleCourse(const std::string &courseId);
+
+        // Returns the number of courses in every shard.
+        int GetSize();
+
+        // Returns the number of departments.
+        size_t GetShardCount();
+
+        // Removes every course and shard.
+        void Clear();
+    };
+
+} // namespace BST
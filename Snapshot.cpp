@@ -0,0 +1,346 @@
+//============================================================================
+// Name        : Snapshot.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Implementation file for the binary catalog snapshot used by the
+//               ABCU Course App. Writes the snapshot layout described in
+//               Snapshot.hpp and serves lookups from a mapped copy of it.
+//============================================================================
+
+#include "Snapshot.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BST
+{
+
+    // Hashes a block of bytes with 64-bit FNV-1a.
+    // Parameters:
+    //   bytes  - Start of the block.
+    //   length - Number of bytes to hash.
+    // Returns: The hash value.
+    uint64_t Fnv1a(const char *bytes, size_t length)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < length; i++)
+        {
+            hash ^= static_cast<unsigned char>(bytes[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // Returns a lowercase copy of a string, the order used by the tree.
+    static std::string ToLower(std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+        return text;
+    }
+
+    // Appends raw bytes of a value or array to a byte vector.
+    static void AppendBytes(std::vector<char> &out, const void *bytes, size_t length)
+    {
+        const char *start = static_cast<const char *>(bytes);
+        out.insert(out.end(), start, start + length);
+    }
+
+    // Saves a loaded catalog to a snapshot file.
+    // Parameters:
+    //   filePath - Path of the snapshot file to write.
+    //   tree     - Reference to the CourseTree holding the catalog.
+    // Returns: True if the snapshot was written, false otherwise.
+    bool SaveSnapshot(const std::string &filePath, CourseTree &tree)
+    {
+        std::vector<Course> courses = tree.GetCoursesInOrder();
+        std::vector<std::string> lowerIds;
+        lowerIds.reserve(courses.size());
+        for (const Course &course : courses)
+        {
+            lowerIds.push_back(ToLower(course.courseId));
+        }
+
+        std::vector<SnapshotRecord> records;
+        std::vector<uint32_t> keys;
+        std::vector<uint32_t> edges;
+        std::string strings;
+        records.reserve(courses.size());
+        keys.reserve(courses.size());
+
+        for (size_t i = 0; i < courses.size(); i++)
+        {
+            const Course &course = courses[i];
+            SnapshotRecord record;
+            record.idOffset = static_cast<uint32_t>(strings.size());
+            record.idLength = static_cast<uint32_t>(course.courseId.size());
+            strings += course.courseId;
+            keys.push_back(static_cast<uint32_t>(strings.size()));
+            strings += lowerIds[i];
+            record.nameOffset = static_cast<uint32_t>(strings.size());
+            record.nameLength = static_cast<uint32_t>(course.courseName.size());
+            strings += course.courseName;
+
+            // Resolve each prerequisite to the index of its record.
+            record.firstPrereq = static_cast<uint32_t>(edges.size());
+            record.prereqCount = static_cast<uint32_t>(course.prereqs.size());
+            for (const std::string &prereq : course.prereqs)
+            {
+                std::string key = ToLower(prereq);
+                auto found = std::lower_bound(lowerIds.begin(), lowerIds.end(), key);
+                if (found == lowerIds.end() || *found != key)
+                {
+                    std::cerr << "Snapshot not saved, unknown prerequisite: " << prereq << std::endl;
+                    return false;
+                }
+                edges.push_back(static_cast<uint32_t>(found - lowerIds.begin()));
+            }
+            records.push_back(record);
+        }
+
+        if (strings.size() > UINT32_MAX - 4)
+        {
+            std::cerr << "Snapshot not saved, catalog is too large." << std::endl;
+            return false;
+        }
+        strings.resize((strings.size() + 3) / 4 * 4, '\0');
+
+        std::vector<char> body;
+        AppendBytes(body, records.data(), records.size() * sizeof(SnapshotRecord));
+        AppendBytes(body, keys.data(), keys.size() * sizeof(uint32_t));
+        AppendBytes(body, edges.data(), edges.size() * sizeof(uint32_t));
+        AppendBytes(body, strings.data(), strings.size());
+
+        SnapshotHeader header;
+        std::memcpy(header.magic, "ABCUSNAP", sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.courseCount = static_cast<uint32_t>(records.size());
+        header.edgeCount = static_cast<uint32_t>(edges.size());
+        header.stringBytes = static_cast<uint32_t>(strings.size());
+        header.checksum = Fnv1a(body.data(), body.size());
+
+        std::ofstream out(filePath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(body.data(), body.size());
+        return out.good();
+    }
+
+    // MappedCatalog class implementation.
+
+    // Constructor: Initializes a catalog with no file open.
+    MappedCatalog::MappedCatalog()
+        : data(nullptr), length(0), records(nullptr), keys(nullptr), edges(nullptr), strings(nullptr), courseCount(0)
+    {
+    }
+
+    // Destructor: Unmaps any open snapshot.
+    MappedCatalog::~MappedCatalog()
+    {
+        this->Close();
+    }
+
+    // Maps a snapshot file and checks its header, layout and checksum.
+    // Parameters:
+    //   filePath - Path of the snapshot file.
+    // Returns: True if the snapshot is usable, false if missing or corrupt.
+    bool MappedCatalog::Open(const std::string &filePath)
+    {
+        this->Close();
+
+#ifndef _WIN32
+        int fd = ::open(filePath.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SnapshotHeader)))
+        {
+            ::close(fd);
+            return false;
+        }
+        void *mapped = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            return false;
+        }
+        this->data = static_cast<const char *>(mapped);
+        this->length = info.st_size;
+#else
+        std::ifstream in(filePath, std::ios::binary);
+        if (!in)
+        {
+            return false;
+        }
+        this->buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        if (this->buffer.size() < sizeof(SnapshotHeader))
+        {
+            this->buffer.clear();
+            return false;
+        }
+        this->data = this->buffer.data();
+        this->length = this->buffer.size();
+#endif
+
+        // Check the header and that the sections exactly fill the file.
+        const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader *>(this->data);
+        uint64_t expected = sizeof(SnapshotHeader) +
+                            uint64_t(header->courseCount) * (sizeof(SnapshotRecord) + sizeof(uint32_t)) +
+                            uint64_t(header->edgeCount) * sizeof(uint32_t) + header->stringBytes;
+        const char *body = this->data + sizeof(SnapshotHeader);
+        if (std::memcmp(header->magic, "ABCUSNAP", sizeof(header->magic)) != 0 ||
+            header->version != SNAPSHOT_VERSION || expected != this->length ||
+            Fnv1a(body, this->length - sizeof(SnapshotHeader)) != header->checksum)
+        {
+            this->Close();
+            return false;
+        }
+
+        this->courseCount = header->courseCount;
+        this->records = reinterpret_cast<const SnapshotRecord *>(body);
+        this->keys = reinterpret_cast<const uint32_t *>(this->records + this->courseCount);
+        this->edges = this->keys + this->courseCount;
+        this->strings = reinterpret_cast<const char *>(this->edges + header->edgeCount);
+
+        // Check every record against the sections it points into, so a snapshot
+        // from a faulty writer is rejected here instead of read out of bounds.
+        uint64_t stringBytes = header->stringBytes;
+        for (uint32_t i = 0; i < this->courseCount; i++)
+        {
+            const SnapshotRecord &record = this->records[i];
+            if (uint64_t(record.idOffset) + record.idLength > stringBytes ||
+                uint64_t(record.nameOffset) + record.nameLength > stringBytes ||
+                uint64_t(this->keys[i]) + record.idLength > stringBytes ||
+                uint64_t(record.firstPrereq) + record.prereqCount > header->edgeCount)
+            {
+                this->Close();
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < header->edgeCount; i++)
+        {
+            if (this->edges[i] >= this->courseCount)
+            {
+                this->Close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Unmaps the snapshot file.
+    void MappedCatalog::Close()
+    {
+#ifndef _WIN32
+        if (this->data != nullptr)
+        {
+            ::munmap(const_cast<char *>(this->data), this->length);
+        }
+#endif
+        this->buffer.clear();
+        this->data = nullptr;
+        this->length = 0;
+        this->records = nullptr;
+        this->keys = nullptr;
+        this->edges = nullptr;
+        this->strings = nullptr;
+        this->courseCount = 0;
+    }
+
+    // Returns true while a snapshot is open.
+    bool MappedCatalog::IsOpen()
+    {
+        return this->data != nullptr;
+    }
+
+    // Returns the number of courses in the snapshot.
+    int MappedCatalog::GetSize()
+    {
+        return static_cast<int>(this->courseCount);
+    }
+
+    // Builds a Course from one record.
+    // Parameters:
+    //   index - Index of the record.
+    // Returns: The course with its ID, name and prerequisite IDs.
+    Course MappedCatalog::RecordToCourse(uint32_t index)
+    {
+        const SnapshotRecord &record = this->records[index];
+        Course course;
+        course.courseId.assign(this->strings + record.idOffset, record.idLength);
+        course.courseName.assign(this->strings + record.nameOffset, record.nameLength);
+        for (uint32_t i = 0; i < record.prereqCount; i++)
+        {
+            const SnapshotRecord &prereq = this->records[this->edges[record.firstPrereq + i]];
+            course.prereqs.emplace_back(this->strings + prereq.idOffset, prereq.idLength);
+        }
+        return course;
+    }
+
+    // Searches for a course by ID with a binary search over the sorted keys.
+    // Parameters:
+    //   courseId - The course ID to search for.
+    //   course   - Reference to a Course object to store the found course.
+    // Returns: True if the course was found.
+    bool MappedCatalog::FindCourse(const std::string &courseId, Course &course)
+    {
+        std::string key = ToLower(courseId);
+        uint32_t low = 0;
+        uint32_t high = this->courseCount;
+        while (low < high)
+        {
+            uint32_t mid = low + (high - low) / 2;
+            std::string_view candidate(this->strings + this->keys[mid], this->records[mid].idLength);
+            int result = candidate.compare(key);
+            if (result == 0)
+            {
+                course = this->RecordToCourse(mid);
+                return true;
+            }
+            if (result < 0)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        return false;
+    }
+
+    // Prints all courses in sorted order.
+    void MappedCatalog::PrintOrdered()
+    {
+        for (uint32_t i = 0; i < this->courseCount; i++)
+        {
+            CourseTree::PrintIdDescription(this->RecordToCourse(i));
+        }
+    }
+
+    // Prints details of a single course by ID.
+    // Parameters:
+    //   courseId - The course ID to print.
+    void MappedCatalog::PrintSingleCourse(std::string courseId)
+    {
+        Course course;
+        if (this->FindCourse(courseId, course))
+        {
+            CourseTree::PrintCourse(course);
+        }
+        else
+        {
+            std::cout << "Course not found." << std::endl;
+        }
+    }
+
+} // namespace BST
@@ -0,0 +1,124 @@
+//============================================================================
+// Name        : Snapshot.hpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Header file for the binary catalog snapshot used by the ABCU
+//               Course App. A validated catalog can be saved to a versioned
+//               snapshot file and later memory mapped to answer lookups at
+//               startup without parsing, inserting or validating anything.
+//============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BST.hpp"
+
+namespace BST
+{
+
+    // Hashes a block of bytes with 64-bit FNV-1a, the checksum of snapshot and
+    // block files.
+    // Parameters:
+    //   bytes  - Start of the block.
+    //   length - Number of bytes to hash.
+    //   Returns: The hash value.
+    uint64_t Fnv1a(const char *bytes, size_t length);
+
+    // Current snapshot format version. Files with any other version are rejected.
+    const uint32_t SNAPSHOT_VERSION = 1;
+
+    // Fixed header at the start of a snapshot file. It is followed by the course
+    // records, the sorted key array, the prerequisite edges and the string table.
+    struct SnapshotHeader
+    {
+        char magic[8];        // Always "ABCUSNAP".
+        uint32_t version;     // Format version, see SNAPSHOT_VERSION.
+        uint32_t courseCount; // Number of course records and keys.
+        uint32_t edgeCount;   // Number of prerequisite edges.
+        uint32_t stringBytes; // Size of the string table, padded to 4 bytes.
+        uint64_t checksum;    // FNV-1a hash of everything after the header.
+    };
+
+    // One course in a snapshot. Records are stored sorted by case-insensitive ID.
+    struct SnapshotRecord
+    {
+        uint32_t idOffset;    // Offset of the course ID in the string table.
+        uint32_t idLength;    // Length of the course ID (and of its key).
+        uint32_t nameOffset;  // Offset of the course name in the string table.
+        uint32_t nameLength;  // Length of the course name.
+        uint32_t firstPrereq; // Index of the course's first edge.
+        uint32_t prereqCount; // Number of edges belonging to the course.
+    };
+
+    // Saves a loaded catalog to a snapshot file. Prerequisites are stored as record
+    // indices, so the catalog should have passed ValidateCourses first.
+    // Parameters:
+    //   filePath - Path of the snapshot file to write.
+    //   tree     - Reference to the CourseTree holding the catalog.
+    // Returns: True if the snapshot was written, false if a prerequisite did not
+    //          resolve or the file could not be written.
+    bool SaveSnapshot(const std::string &filePath, CourseTree &tree);
+
+    // Read-only catalog served straight from a memory mapped snapshot file.
+    class MappedCatalog
+    {
+    private:
+        const char *data;              // Start of the mapped file.
+        size_t length;                 // Size of the mapped file in bytes.
+        std::vector<char> buffer;      // File contents where memory mapping is unavailable.
+        const SnapshotRecord *records; // Course records, sorted by ID.
+        const uint32_t *keys;          // String table offsets of the lowercase IDs.
+        const uint32_t *edges;         // Record index of every prerequisite.
+        const char *strings;           // String table.
+        uint32_t courseCount;          // Number of courses in the snapshot.
+
+        // Builds a Course from one record.
+        // Parameters:
+        //   index - Index of the record.
+        //   Returns: The course with its ID, name and prerequisite IDs.
+        Course RecordToCourse(uint32_t index);
+
+    public:
+        // Constructor: Initializes a catalog with no file open.
+        MappedCatalog();
+
+        // Destructor: Unmaps any open snapshot.
+        ~MappedCatalog();
+
+        MappedCatalog(const MappedCatalog &) = delete;
+        MappedCatalog &operator=(const MappedCatalog &) = delete;
+
+        // Maps a snapshot file and checks its header, layout and checksum.
+        // Parameters:
+        //   filePath - Path of the snapshot file.
+        //   Returns: True if the snapshot is usable, false if missing or corrupt.
+        bool Open(const std::string &filePath);
+
+        // Unmaps the snapshot file.
+        void Close();
+
+        // Returns true while a snapshot is open.
+        bool IsOpen();
+
+        // Returns the number of courses in the snapshot.
+        int GetSize();
+
+        // Searches for a course by ID (case-insensitive).
+        // Parameters:
+        //   courseId - The course ID to search for.
+        //   course   - Reference to a Course object to store the found course.
+        //   Returns: True if the course was found.
+        bool FindCourse(const std::string &courseId, Course &course);
+
+        // Prints all courses in sorted order.
+        void PrintOrdered();
+
+        // Prints details of a single course by ID.
+        // Parameters:
+        //   courseId - The course ID to print.
+        void PrintSingleCourse(std::string courseId);
+    };
+
+} // namespace BST
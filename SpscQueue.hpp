@@ -0,0 +1,91 @@
+//============================================================================
+// Name        : SpscQueue.hpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Header file defining the bounded single-producer, single-consumer
+//               queue of the ABCU Course App. The background loader's reader
+//               thread pushes parsed courses into it and its inserter thread pops
+//               them, without either thread ever taking a lock.
+//============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace BST
+{
+
+    // Fixed-size ring buffer for exactly one pushing thread and one popping thread.
+    // Each side owns one index and only reads the other's, so pushes and pops are
+    // a load, a move and a store with no lock or compare-and-swap.
+    template <typename Value>
+    class SpscQueue
+    {
+    private:
+        // Indexes on separate cache lines so the two threads do not contend.
+        alignas(64) std::atomic<size_t> head{0}; // Next slot to pop, written by the consumer.
+        alignas(64) std::atomic<size_t> tail{0}; // Next slot to push, written by the producer.
+        alignas(64) std::vector<Value> slots;    // Ring of values, a power of two long.
+        size_t mask;                             // Slot count minus one, to wrap indexes.
+
+    public:
+        // Creates an empty queue.
+        // Parameters:
+        //   capacity - Most values held at once, rounded up to a power of two.
+        explicit SpscQueue(size_t capacity)
+        {
+            size_t slotCount = 2;
+            while (slotCount < capacity)
+            {
+                slotCount *= 2;
+            }
+            this->slots.resize(slotCount);
+            this->mask = slotCount - 1;
+        }
+
+        SpscQueue(const SpscQueue &) = delete;
+        SpscQueue &operator=(const SpscQueue &) = delete;
+
+        // Moves a value into the queue. Producer thread only.
+        // Parameters:
+        //   value - The value to push, left untouched if the queue is full.
+        //   Returns: True if the value was pushed, false if the queue is full.
+        bool TryPush(Value &value)
+        {
+            size_t position = this->tail.load(std::memory_order_relaxed);
+            if (position - this->head.load(std::memory_order_acquire) == this->slots.size())
+            {
+                return false;
+            }
+            this->slots[position & this->mask] = std::move(value);
+            this->tail.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Moves the oldest value out of the queue. Consumer thread only.
+        // Parameters:
+        //   value - Receives the popped value.
+        //   Returns: True if a value was popped, false if the queue is empty.
+        bool TryPop(Value &value)
+        {
+            size_t position = this->head.load(std::memory_order_relaxed);
+            if (position == this->tail.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            value = std::move(this->slots[position & this->mask]);
+            this->head.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Returns the number of values waiting. Exact only when both sides are idle.
+        size_t GetSize()
+        {
+            return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire);
+        }
+    };
+
+} // namespace BST
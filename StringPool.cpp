@@ -0,0 +1,104 @@
+//============================================================================
+// Name        : StringPool.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Implementation file for the course ID string pool of the ABCU
+//               Course App.
+//============================================================================
+
+#include "StringPool.hpp"
+#include "BST.hpp"
+#include <algorithm>
+
+namespace BST
+{
+
+    // Hashes a string with 64-bit FNV-1a, ignoring case.
+    // Parameters:
+    //   text - The string to hash.
+    // Returns: The hash value.
+    uint64_t StringPool::Hash(std::string_view text)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (char c : text)
+        {
+            hash ^= NoCaseCompare::Fold(c);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // Returns the slot holding a string, or the empty slot where it would go.
+    // The table is never full, so linear probing always ends.
+    // Parameters:
+    //   text - The string to look for.
+    size_t StringPool::FindSlot(std::string_view text)
+    {
+        NoCaseCompare compare;
+        size_t mask = this->slots.size() - 1;
+        size_t slot = Hash(text) & mask;
+        while (this->slots[slot] != nullptr && compare(this->slots[slot]->text, text) != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    // Doubles the table and re-inserts every entry.
+    void StringPool::Grow()
+    {
+        this->slots.assign(std::max<size_t>(64, this->slots.size() * 2), nullptr);
+        for (PooledString &entry : this->entries)
+        {
+            this->slots[this->FindSlot(entry.text)] = &entry;
+        }
+    }
+
+    // Returns the handle of a string, adding it to the pool if it is new.
+    // Parameters:
+    //   text - The string to intern.
+    // Returns: The handle, equal for strings that differ only in case.
+    StringHandle StringPool::Intern(std::string_view text)
+    {
+        // Keep the table at most half full so probe runs stay short.
+        if ((this->entries.size() + 1) * 2 > this->slots.size())
+        {
+            this->Grow();
+        }
+        size_t slot = this->FindSlot(text);
+        if (this->slots[slot] == nullptr)
+        {
+            this->entries.push_back(PooledString{std::string(text)});
+            this->slots[slot] = &this->entries.back();
+        }
+        return this->slots[slot];
+    }
+
+    // Returns the handle of a string without adding it.
+    // Parameters:
+    //   text - The string to look up.
+    // Returns: The handle, or nullptr if the string was never interned.
+    StringHandle StringPool::Find(std::string_view text)
+    {
+        if (this->slots.empty())
+        {
+            return nullptr;
+        }
+        return this->slots[this->FindSlot(text)];
+    }
+
+    // Removes every string.
+    void StringPool::Clear()
+    {
+        this->entries.clear();
+        this->slots.clear();
+        this->slots.shrink_to_fit();
+    }
+
+    // Returns the number of pooled strings.
+    size_t StringPool::GetSize()
+    {
+        return this->entries.size();
+    }
+
+} // namespace BST
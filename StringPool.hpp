@@ -0,0 +1,69 @@
+//============================================================================
+// Name        : StringPool.hpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Header file for the course ID string pool of the ABCU Course
+//               App. Every distinct course ID, whether a course's own ID or a
+//               prerequisite reference, is stored once. Courses hold small
+//               handles into the pool, so equal IDs are the same handle.
+//============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BST
+{
+
+    // One string in the pool. Entries never move, so a pointer to one is a handle.
+    struct PooledString
+    {
+        std::string text;       // The ID, spelled as its course spells it once loaded.
+        bool inCatalog = false; // True while a course with this ID is in the tree.
+    };
+
+    // Handle to a pooled string. Two IDs that differ only in case share a handle.
+    using StringHandle = PooledString *;
+
+    // Case-insensitive string interner. Lookups use an open addressing table of
+    // entry pointers, which costs far less per string than a node-based map.
+    class StringPool
+    {
+    private:
+        std::deque<PooledString> entries;  // Pooled strings, in the order they were added.
+        std::vector<PooledString *> slots; // Hash table of entries, nullptr for empty slots.
+
+        // Hashes a string with 64-bit FNV-1a, ignoring case.
+        static uint64_t Hash(std::string_view text);
+
+        // Returns the slot holding a string, or the empty slot where it would go.
+        size_t FindSlot(std::string_view text);
+
+        // Doubles the table and re-inserts every entry.
+        void Grow();
+
+    public:
+        // Returns the handle of a string, adding it to the pool if it is new.
+        // Parameters:
+        //   text - The string to intern.
+        //   Returns: The handle, equal for strings that differ only in case.
+        StringHandle Intern(std::string_view text);
+
+        // Returns the handle of a string without adding it.
+        // Parameters:
+        //   text - The string to look up.
+        //   Returns: The handle, or nullptr if the string was never interned.
+        StringHandle Find(std::string_view text);
+
+        // Removes every string. All handles become invalid.
+        void Clear();
+
+        // Returns the number of pooled strings.
+        size_t GetSize();
+    };
+
+} // namespace BST
@@ -0,0 +1,120 @@
+//============================================================================
+// Name        : SuggestionIndex.cpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Implementation file for the course ID suggestion index of the
+//               ABCU Course App.
+//============================================================================
+
+#include "SuggestionIndex.hpp"
+#include "BST.hpp"
+#include <algorithm>
+
+namespace BST
+{
+
+    // Adds an ID to the index.
+    // Parameters:
+    //   id - The ID to add, not already in the index.
+    void SuggestionIndex::Add(std::string_view id)
+    {
+        NoCaseCompare compare;
+        if (this->pending.empty() && (this->ids.empty() || compare(this->ids.back(), id) < 0))
+        {
+            this->ids.emplace_back(id);
+            this->removed.push_back(false);
+        }
+        else
+        {
+            this->pending.emplace_back(id);
+        }
+    }
+
+    // Removes an ID, ignoring case, by marking it removed.
+    // Parameters:
+    //   id - The ID to remove.
+    // Returns: True if the ID was found and removed.
+    bool SuggestionIndex::Remove(std::string_view id)
+    {
+        this->MergePending();
+        NoCaseCompare compare;
+        auto found = std::lower_bound(this->ids.begin(), this->ids.end(), id, [&compare](const std::string &current, std::string_view wanted)
+                                      { return compare(current, wanted) < 0; });
+        if (found == this->ids.end() || compare(*found, id) != 0 || this->removed[found - this->ids.begin()])
+        {
+            return false;
+        }
+        this->removed[found - this->ids.begin()] = true;
+        this->removedCount++;
+        return true;
+    }
+
+    // Removes every ID.
+    void SuggestionIndex::Clear()
+    {
+        this->ids.clear();
+        this->pending.clear();
+        this->removed.clear();
+        this->removedCount = 0;
+    }
+
+    // Merges the pending IDs into the sorted IDs. Removed IDs are dropped first,
+    // so an ID removed and added back is only kept once.
+    void SuggestionIndex::MergePending()
+    {
+        if (this->pending.empty())
+        {
+            return;
+        }
+        if (this->removedCount > 0)
+        {
+            size_t kept = 0;
+            for (size_t i = 0; i < this->ids.size(); i++)
+            {
+                if (!this->removed[i])
+                {
+                    if (kept != i)
+                    {
+                        this->ids[kept] = std::move(this->ids[i]);
+                    }
+                    kept++;
+                }
+            }
+            this->ids.resize(kept);
+            this->removedCount = 0;
+        }
+        NoCaseCompare compare;
+        auto less = [&compare](const std::string &first, const std::string &second)
+        { return compare(first, second) < 0; };
+        std::sort(this->pending.begin(), this->pending.end(), less);
+        size_t middle = this->ids.size();
+        this->ids.insert(this->ids.end(), std::make_move_iterator(this->pending.begin()),
+                         std::make_move_iterator(this->pending.end()));
+        std::inplace_merge(this->ids.begin(), this->ids.begin() + middle, this->ids.end(), less);
+        this->pending.clear();
+        this->removed.assign(this->ids.size(), false);
+    }
+
+    // Returns the IDs closest to a query, ignoring case, by walking the sorted IDs.
+    // Parameters:
+    //   query - The ID that was not found.
+    //   limit - Most suggestions to return.
+    // Returns: Suggestions, closest first and then by ID.
+    std::vector<std::string> SuggestionIndex::Suggest(std::string_view query, size_t limit)
+    {
+        this->MergePending();
+        std::vector<std::pair<int, size_t>> found = SuggestSortedIds<NoCaseCompare>(
+            this->ids.size(), [this](size_t index) -> std::string_view
+            { return this->ids[index]; },
+            [this](size_t index)
+            { return !this->removed[index]; },
+            query, limit);
+        std::vector<std::string> suggestions;
+        for (const std::pair<int, size_t> &match : found)
+        {
+            suggestions.push_back(this->ids[match.second]);
+        }
+        return suggestions;
+    }
+
+} // namespace BST
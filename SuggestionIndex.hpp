@@ -0,0 +1,190 @@
+//============================================================================
+// Name        : SuggestionIndex.hpp
+// Author      : Shannon Musgrave
+// Version     : 1.0
+// Description : Header file for the course ID suggestion index of the ABCU Course
+//               App. Finds the IDs within a small edit distance of a mistyped ID
+//               so a failed lookup can answer "Did you mean ...?".
+//============================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace BST
+{
+
+    // Walks the IDs in [start, end) of a sorted ID sequence, which share their
+    // first depth characters, and collects those within maxDistance of the query.
+    // The recursion is at most one level per character of the longest ID.
+    // Parameters:
+    //   idAt        - Returns the ID at an index, as something viewable as a std::string_view.
+    //   isLive      - Returns false for an index to leave out of the results.
+    //   query       - Folded query.
+    //   start, end  - Range of IDs sharing a prefix of length depth.
+    //   depth       - Length of the shared prefix.
+    //   rows        - Distance table, row depth holds the distances for the prefix.
+    //   maxDistance - Largest edit distance to accept.
+    //   found       - Receives (distance, index) of every match.
+    template <typename Compare, typename IdAt, typename IsLive>
+    void WalkSortedIds(IdAt &idAt, IsLive &isLive, std::string_view query, size_t start, size_t end, size_t depth,
+                       std::vector<int> &rows, int maxDistance, std::vector<std::pair<int, size_t>> &found)
+    {
+        size_t width = query.size() + 1;
+        if (rows.size() < (depth + 2) * width)
+        {
+            rows.resize((depth + 2) * width);
+        }
+
+        // An ID that ends here sorts before its longer neighbours.
+        while (start < end)
+        {
+            auto id = idAt(start);
+            if (std::string_view(id).size() > depth)
+            {
+                break;
+            }
+            int distance = rows[depth * width + query.size()];
+            if (distance <= maxDistance && isLive(start))
+            {
+                found.emplace_back(distance, start);
+            }
+            start++;
+        }
+
+        while (start < end)
+        {
+            // IDs with the same next character form one child of the implicit trie.
+            auto first = idAt(start);
+            unsigned char next = Compare::Fold(std::string_view(first)[depth]);
+            size_t low = start + 1;
+            size_t high = end;
+            while (low < high)
+            {
+                size_t mid = low + (high - low) / 2;
+                auto id = idAt(mid);
+                std::string_view view(id);
+                // Sorted IDs sharing the prefix are all longer than it; the check
+                // only keeps an unsorted source from reading past an ID's end.
+                if ((view.size() > depth ? Compare::Fold(view[depth]) : 0) <= next)
+                {
+                    low = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+            size_t childEnd = low;
+
+            // Next row of the distance table for the prefix extended by next. The
+            // rows are found again each time, a deeper walk may have grown them.
+            const int *row = rows.data() + depth * width;
+            int *child = rows.data() + (depth + 1) * width;
+            child[0] = row[0] + 1;
+            int best = child[0];
+            for (size_t j = 1; j < width; j++)
+            {
+                int substitute = row[j - 1] + (static_cast<unsigned char>(query[j - 1]) == next ? 0 : 1);
+                child[j] = std::min({row[j] + 1, child[j - 1] + 1, substitute});
+                best = std::min(best, child[j]);
+            }
+            if (best <= maxDistance)
+            {
+                WalkSortedIds<Compare>(idAt, isLive, query, start, childEnd, depth + 1, rows, maxDistance, found);
+            }
+            start = childEnd;
+        }
+    }
+
+    // Finds the IDs closest to a query in any sequence of IDs sorted by Compare,
+    // read through idAt, so catalogs that already keep their IDs in order (a
+    // shard's tree, a compiled-in array, a block file) can suggest IDs without
+    // an index of their own. IDs one edit away are returned if there are any,
+    // otherwise IDs two edits away.
+    // Parameters:
+    //   count  - Number of IDs.
+    //   idAt   - Returns the ID at an index, as something viewable as a std::string_view.
+    //   isLive - Returns false for an index to leave out of the results.
+    //   query  - The ID that was not found.
+    //   limit  - Most suggestions to return.
+    //   Returns: (distance, index) of the suggestions, closest first and then by index.
+    template <typename Compare, typename IdAt, typename IsLive>
+    std::vector<std::pair<int, size_t>> SuggestSortedIds(size_t count, IdAt idAt, IsLive isLive,
+                                                         std::string_view query, size_t limit)
+    {
+        std::string folded(query);
+        for (char &c : folded)
+        {
+            c = static_cast<char>(Compare::Fold(c));
+        }
+        std::vector<int> rows(2 * (folded.size() + 1));
+        for (size_t j = 0; j <= folded.size(); j++)
+        {
+            rows[j] = static_cast<int>(j);
+        }
+
+        // Look one edit away first, and only widen to two edits if nothing is that close.
+        std::vector<std::pair<int, size_t>> found;
+        for (int maxDistance = 1; maxDistance <= 2 && found.empty(); maxDistance++)
+        {
+            WalkSortedIds<Compare>(idAt, isLive, folded, 0, count, 0, rows, maxDistance, found);
+        }
+        std::sort(found.begin(), found.end());
+        if (found.size() > limit)
+        {
+            found.resize(limit);
+        }
+        return found;
+    }
+
+    // Case-insensitive index of IDs for typo-tolerant lookups.
+    //
+    // The IDs are kept sorted, which makes them an implicit trie: all IDs sharing a
+    // prefix sit next to each other. A search (SuggestSortedIds) walks that trie
+    // depth first, carrying one row of the Levenshtein distance table per character,
+    // and skips any branch whose row is already past the allowed distance (a
+    // Levenshtein automaton). Only the few prefixes close to the query are visited,
+    // however large the catalog.
+    class SuggestionIndex
+    {
+    private:
+        std::vector<std::string> ids;     // IDs sorted case-insensitively.
+        std::vector<std::string> pending; // IDs added out of order, merged in before a search.
+        std::vector<bool> removed;        // Marks removed IDs, parallel to ids.
+        size_t removedCount = 0;          // Number of IDs marked removed.
+
+        // Merges the pending IDs into the sorted IDs, dropping removed ones.
+        void MergePending();
+
+    public:
+        // Adds an ID. IDs added in ascending order go straight into place, others
+        // wait in a buffer that the next search sorts and merges in one pass.
+        // Parameters:
+        //   id - The ID to add, not already in the index.
+        void Add(std::string_view id);
+
+        // Removes an ID, ignoring case. The ID is only marked removed and is
+        // dropped by the next merge, so a removal does not shift the sorted IDs.
+        // Parameters:
+        //   id - The ID to remove.
+        //   Returns: True if the ID was found and removed.
+        bool Remove(std::string_view id);
+
+        // Removes every ID.
+        void Clear();
+
+        // Returns the IDs closest to a query, ignoring case. IDs one edit away are
+        // returned if there are any, otherwise IDs two edits away.
+        // Parameters:
+        //   query - The ID that was not found.
+        //   limit - Most suggestions to return.
+        //   Returns: Suggestions, closest first and then by ID.
+        std::vector<std::string> Suggest(std::string_view query, size_t limit);
+    };
+
+} // namespace BST